@@ -0,0 +1,97 @@
+// Edits and scrolls documents of different lengths in a text editor, run
+// headless using the software backend, and reports the time per frame.
+// The time should stay about the same however long the document is.
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "eggui.hxx"
+#include "software_backend.hxx"
+
+using namespace eggui;
+
+using std::make_shared;
+using std::make_unique;
+
+constexpr int POLLS = 1500;
+constexpr int DOC_LINES[] = {1000, 100'000, 500'000};
+
+static std::string make_document(int lines)
+{
+	std::string doc;
+	for (int i = 0; i < lines; ++i)
+		doc += "key_" + std::to_string(i) + " = \"some configuration value\"\n";
+	return doc;
+}
+
+/// @brief Type, move around and scroll over the document.
+/// @return Seconds to open the editor and seconds per frame.
+static std::pair<double, double> run(int lines)
+{
+	using clock = std::chrono::steady_clock;
+
+	auto backend = make_unique<SoftwareBackend>();
+	auto &sw = *backend;
+	set_backend(std::move(backend));
+
+	auto doc = make_document(lines);
+	auto start = clock::now();
+	auto editor = make_shared<TextEditor>(600, 400, std::move(doc));
+	auto view = make_shared<VScrollView>(600, 400, editor);
+	std::chrono::duration<double> open_time = clock::now() - start;
+
+	int polls = 0;
+	sw.set_poll_callback([&polls](SoftwareBackend &b) {
+		// Click into the editor to focus it, then keep editing.
+		b.move_mouse(Point(100, 100));
+		if (polls == 1)
+			b.press_mouse();
+		if (polls == 2)
+			b.release_mouse();
+
+		switch (polls % 6) {
+		case 0:
+			b.enter_char('a' + polls % 26);
+			break;
+		case 1:
+			b.press_key(Key::Enter);
+			break;
+		case 2:
+			b.press_key(polls % 100 < 50 ? Key::PageDown : Key::Up);
+			break;
+		case 3:
+			b.scroll(Point(0, -3));
+			break;
+		case 4:
+			b.press_key(Key::Backspace);
+			break;
+		case 5:
+			b.press_key(Key::End);
+			break;
+		}
+
+		if (++polls == POLLS)
+			b.request_close();
+	});
+
+	auto window = Window(view);
+	start = clock::now();
+	window.main_loop(640, 480);
+	std::chrono::duration<double> elapsed = clock::now() - start;
+
+	return {open_time.count(), elapsed.count() / sw.get_frame_count()};
+}
+
+int main()
+{
+	std::cout << "Lines       open ms   frame ms\n";
+	for (int lines : DOC_LINES) {
+		auto [open_time, frame_time] = run(lines);
+		std::cout << lines << "\t" << open_time * 1e3 << "\t" << frame_time * 1e3
+				  << '\n';
+	}
+
+	return 0;
+}
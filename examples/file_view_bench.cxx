@@ -0,0 +1,92 @@
+// Opens a large log file in a file view, run headless using the software
+// backend, scrolling it while its lines are being found. Reports how soon
+// the first frame is shown, how long finding the lines takes and the time
+// per frame meanwhile.
+// Usage: file_view_bench [file], a file is generated if none is given.
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "eggui.hxx"
+#include "software_backend.hxx"
+
+using namespace eggui;
+
+using std::make_shared;
+using std::make_unique;
+
+constexpr long GENERATED_LINES = 4'000'000;
+
+static std::string generate_file()
+{
+	std::string path = "file_view_bench.log";
+	std::ofstream out(path, std::ios::binary);
+
+	std::string line;
+	for (long i = 0; i < GENERATED_LINES; ++i) {
+		line = "2024-01-01 00:00:00 INFO worker-" + std::to_string(i % 16)
+			   + " handled request " + std::to_string(i) + '\n';
+		out << line;
+	}
+
+	return path;
+}
+
+int main(int argc, char **argv)
+{
+	using clock = std::chrono::steady_clock;
+
+	std::string path = argc > 1 ? argv[1] : generate_file();
+
+	auto backend = make_unique<SoftwareBackend>();
+	auto &sw = *backend;
+	set_backend(std::move(backend));
+
+	auto start = clock::now();
+	auto file_view = make_shared<FileView>(800, 600, FontSize::Small);
+	if (!file_view->open(path)) {
+		std::cerr << "Could not open " << path << '\n';
+		return 1;
+	}
+	auto view = make_shared<VScrollView>(800, 600, file_view);
+
+	// Keep scrolling down until all the lines are found, then a bit more.
+	clock::time_point first_frame, indexed;
+	long frames_indexing = 0;
+	int polls_after = 0;
+	sw.set_poll_callback([&](SoftwareBackend &b) {
+		if (b.get_frame_count() == 1)
+			first_frame = clock::now();
+
+		b.move_mouse(Point(400, 300));
+		b.scroll(Point(0, -5));
+
+		if (file_view->is_indexing()) {
+			frames_indexing = b.get_frame_count();
+			indexed = clock::now();
+		} else if (++polls_after == 100) {
+			b.request_close();
+		}
+	});
+
+	auto window = Window(view);
+	window.main_loop(820, 600);
+
+	std::chrono::duration<double> to_first = first_frame - start;
+	std::chrono::duration<double> to_indexed = indexed - start;
+	std::cout << "Lines: " << file_view->get_line_count() << '\n'
+			  << "First frame after: " << to_first.count() * 1e3 << " ms\n"
+			  << "All lines found after: " << to_indexed.count() * 1e3
+			  << " ms\n"
+			  << "Frames while finding lines: " << frames_indexing << ", "
+			  << to_indexed.count() * 1e3 / std::max(1L, frames_indexing)
+			  << " ms/frame\n";
+
+	if (argc <= 1)
+		std::remove(path.c_str());
+	return 0;
+}
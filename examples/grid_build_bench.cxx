@@ -0,0 +1,44 @@
+// Builds grids of buttons of growing size, each row started with add_widget
+// and filled left to right with add_widget_beside, the way generated grids
+// are built at startup. Reports the time per widget added, which stays the
+// same as the grid grows if building takes linear time.
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+#include "eggui.hxx"
+
+using namespace eggui;
+
+using std::make_shared;
+
+constexpr int COLS = 50;
+constexpr int ROW_COUNTS[] = {1'000, 2'000, 4'000, 8'000};
+
+int main()
+{
+	for (int rows : ROW_COUNTS) {
+		auto grid = make_shared<Grid>();
+
+		auto start = std::chrono::steady_clock::now();
+		long added = 0;
+		for (int r = 0; r < rows; ++r) {
+			Widget *last = grid->add_widget(make_shared<Button>(10, 10, ""), 0, r);
+			added += last != nullptr;
+			for (int c = 1; c < COLS; ++c) {
+				auto button = make_shared<Button>(10, 10, "");
+				last = grid->add_widget_beside(button, last, Direction::Left);
+				added += last != nullptr;
+			}
+		}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now()
+												- start;
+
+		std::cout << rows << "x" << COLS << ": " << added << " added in "
+				  << elapsed.count() * 1e3 << " ms, "
+				  << elapsed.count() * 1e9 / (rows * COLS) << " ns/widget\n";
+	}
+
+	return 0;
+}
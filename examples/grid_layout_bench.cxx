@@ -0,0 +1,64 @@
+// Lays out a grid of 10,000 rows and 50 columns of buttons, with a header
+// spanning all the columns every 100 rows and a side bar spanning those 100
+// rows beside them. Reports the time taken to measure the grid and to place
+// its children, each averaged over several layouts.
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+#include "eggui.hxx"
+
+using namespace eggui;
+
+using std::make_shared;
+
+constexpr int ROWS = 10'000;
+constexpr int COLS = 50;
+constexpr int SECTION_ROWS = 100;
+constexpr int LAYOUTS = 20;
+
+int main()
+{
+	using clock = std::chrono::steady_clock;
+
+	auto grid = make_shared<Grid>();
+	grid->set_row_gap(1);
+	grid->set_col_gap(1);
+	for (int r = 0; r < ROWS; r += SECTION_ROWS) {
+		grid->add_widget(make_shared<Button>(200, 20, ""), 0, r, COLS);
+		grid->add_widget(
+			make_shared<Button>(40, 400, ""), COLS, r, 1, SECTION_ROWS
+		);
+		for (int i = 1; i < SECTION_ROWS; ++i) {
+			for (int c = 0; c < COLS; ++c)
+				grid->add_widget(make_shared<Button>(10, 10, ""), c, r + i);
+		}
+	}
+
+	clock::duration measuring{}, placing{};
+	for (int i = 0; i < LAYOUTS; ++i) {
+		grid->invalidate_layout();
+
+		auto start = clock::now();
+		auto size = grid->update_layout_info();
+		auto measured = clock::now();
+		// Alternate sizes, so that the cells are stretched differently.
+		grid->set_size(size + Point(i % 2 * 100, i % 2 * 1000));
+		auto placed = clock::now();
+
+		measuring += measured - start;
+		placing += placed - measured;
+	}
+
+	std::chrono::duration<double> measure_time = measuring;
+	std::chrono::duration<double> place_time = placing;
+	std::cout << "Grid: " << ROWS << "x" << COLS << ", size "
+			  << grid->get_size().x << "x" << grid->get_size().y << '\n'
+			  << "Measuring: " << measure_time.count() * 1e3 / LAYOUTS
+			  << " ms/layout\n"
+			  << "Placing: " << place_time.count() * 1e3 / LAYOUTS
+			  << " ms/layout\n";
+
+	return 0;
+}
@@ -0,0 +1,73 @@
+// Runs a window headless using the software backend, moving the mouse over
+// a grid of buttons every frame, and reports the frame throughput.
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+
+#include "eggui.hxx"
+#include "software_backend.hxx"
+
+using namespace eggui;
+
+using std::make_unique;
+
+constexpr int ROWS = 20;
+constexpr int COLS = 10;
+constexpr int POLLS = 2000;
+
+int main()
+{
+	auto grid = make_unique<Grid>();
+	grid->set_row_gap(4);
+	grid->set_col_gap(4);
+	for (int r = 0; r < ROWS; ++r) {
+		for (int c = 0; c < COLS; ++c)
+			grid->add_widget(make_unique<Button>(90, 30, "Button"), c, r);
+	}
+
+	auto backend = make_unique<SoftwareBackend>();
+	auto &sw = *backend;
+	set_backend(std::move(backend));
+
+	// Sweep the cursor diagonally over the window, once per poll.
+	int polls = 0;
+	sw.set_poll_callback([&polls](SoftwareBackend &b) {
+		auto size = b.get_window_size();
+		int x = polls * 7 % size.x;
+		int y = polls * 3 % size.y;
+		b.move_mouse(Point(x, y));
+
+		if (++polls == POLLS)
+			b.request_close();
+	});
+
+	auto window = Window(std::move(grid));
+	auto start = std::chrono::steady_clock::now();
+	window.main_loop();
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now()
+											- start;
+
+	// Checksum of the last frame, for comparing against a known good run.
+	std::uint32_t checksum = 0;
+	for (auto px : sw.get_pixels())
+		checksum = checksum * 31 + (px.r << 16 | px.g << 8 | px.b);
+
+	std::cout << "Polls: " << polls << ", frames: " << sw.get_frame_count()
+			  << ", time: " << elapsed.count() << " s, "
+			  << sw.get_frame_count() / elapsed.count() << " frames/s\n"
+			  << "Last frame checksum: " << checksum << '\n';
+
+	auto stats = get_text_cache_stats();
+	std::cout << "Text cache hits: " << stats.hits
+			  << ", misses: " << stats.misses
+			  << ", evictions: " << stats.evictions << '\n';
+
+	auto clips = get_clip_stats();
+	std::cout << "Clip area changes requested: " << clips.requested
+			  << ", applied: " << clips.applied
+			  << ", flushes avoided: " << clips.calc_avoided() << '\n';
+
+	return 0;
+}
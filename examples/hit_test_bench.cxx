@@ -0,0 +1,69 @@
+// Finds the widget under random points of a 100x100 grid of buttons, the
+// way the window does to find the hovered widget, run headless using the
+// software backend. Reports the time per lookup.
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+
+#include "eggui.hxx"
+#include "software_backend.hxx"
+
+using namespace eggui;
+
+using std::make_shared;
+using std::make_unique;
+
+constexpr int ROWS = 100;
+constexpr int COLS = 100;
+constexpr int LOOKUPS = 1'000'000;
+
+int main()
+{
+	auto grid = make_shared<Grid>();
+	grid->set_row_gap(2);
+	grid->set_col_gap(2);
+	for (int r = 0; r < ROWS; ++r) {
+		for (int c = 0; c < COLS; ++c)
+			grid->add_widget(make_shared<Button>(10, 10, ""), c, r);
+	}
+
+	auto backend = make_unique<SoftwareBackend>();
+	auto &sw = *backend;
+	set_backend(std::move(backend));
+
+	// Look up once the grid is laid out and shown.
+	Window *window_ptr = nullptr;
+	double seconds = 0;
+	long found = 0;
+	sw.set_poll_callback([&](SoftwareBackend &b) {
+		if (b.get_frame_count() == 0)
+			return;
+
+		std::mt19937 rng(1);
+		auto size = grid->get_size();
+		std::uniform_int_distribution<int> xdist(0, size.x - 1);
+		std::uniform_int_distribution<int> ydist(0, size.y - 1);
+
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < LOOKUPS; ++i) {
+			Point pos(xdist(rng), ydist(rng));
+			Event ev(*window_ptr, EventType::IsInteractive, pos);
+			found += notify_widget(*grid, ev) != nullptr;
+		}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now()
+												- start;
+		seconds = elapsed.count();
+		b.request_close();
+	});
+
+	auto window = Window(grid);
+	window_ptr = &window;
+	window.main_loop(1200, 1200);
+
+	std::cout << "Lookups: " << LOOKUPS << ", found: " << found << ", "
+			  << seconds * 1e9 / LOOKUPS << " ns/lookup\n";
+
+	return 0;
+}
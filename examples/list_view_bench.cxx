@@ -0,0 +1,103 @@
+// Scrolls through lists of labels run headless using the software backend,
+// once with a label per item in a linear box and once with a list view which
+// recycles its rows. Reports the time to show the first frame, the time per
+// frame while scrolling and the number of widgets created.
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "eggui.hxx"
+#include "software_backend.hxx"
+
+using namespace eggui;
+
+using std::make_shared;
+using std::make_unique;
+
+constexpr int ROW_HEIGHT = 24;
+constexpr int POLLS = 300;
+constexpr RGBA ITEM_COLOR(230, 230, 230);
+
+static std::string item_text(int i) { return "Item " + std::to_string(i); }
+
+/// @brief Run a window with the view, scrolling it down every poll.
+/// @param count_widgets Gives the number of widgets created, once run.
+static void run(
+	SoftwareBackend &sw, std::shared_ptr<Widget> view,
+	const std::function<long()> &count_widgets
+)
+{
+	using clock = std::chrono::steady_clock;
+
+	auto start = clock::now();
+	clock::time_point first_frame;
+	int polls = 0;
+	sw.set_poll_callback([&](SoftwareBackend &b) {
+		if (polls == 0)
+			first_frame = clock::now();
+
+		b.move_mouse(Point(200, 300));
+		b.scroll(Point(0, -10));
+		if (++polls == POLLS)
+			b.request_close();
+	});
+
+	auto frames_before = sw.get_frame_count();
+	auto window = Window(std::move(view));
+	window.main_loop(420, 600);
+	auto end = clock::now();
+
+	std::chrono::duration<double> to_first = first_frame - start;
+	std::chrono::duration<double> scrolling = end - first_frame;
+	auto frames = sw.get_frame_count() - frames_before;
+	std::cout << "  widgets: " << count_widgets()
+			  << ", first frame after: " << to_first.count() * 1e3 << " ms, "
+			  << scrolling.count() * 1e3 / std::max<long>(1, frames)
+			  << " ms/frame\n";
+}
+
+int main()
+{
+	auto backend = make_unique<SoftwareBackend>();
+	auto &sw = *backend;
+	set_backend(std::move(backend));
+
+	for (int count : {1'000, 10'000, 30'000}) {
+		std::cout << count << " items\n";
+
+		std::cout << " linear box\n";
+		auto box = make_shared<LinearBox>(Orientation::Vertical);
+		for (int i = 0; i < count; ++i) {
+			box->add_widget_start(
+				make_shared<Label>(400, ROW_HEIGHT, item_text(i), ITEM_COLOR)
+			);
+		}
+		run(sw, make_shared<VScrollView>(400, 600, box), [count]() {
+			return count;
+		});
+
+		std::cout << " list view\n";
+		auto list = make_shared<ListView>(
+			400, ROW_HEIGHT,
+			ListSource{
+				.get_count = [count]() { return count; },
+				.make_row =
+					[]() {
+						return make_shared<Label>(400, ROW_HEIGHT, "", ITEM_COLOR);
+					},
+				.bind_row =
+					[](Widget &row, int i) {
+						static_cast<Label &>(row).set_text(item_text(i));
+					},
+			}
+		);
+		run(sw, make_shared<VScrollView>(400, 600, list), [&list]() {
+			return list->get_row_count();
+		});
+	}
+
+	return 0;
+}
@@ -0,0 +1,90 @@
+// Streams lines from several threads into a log view, run headless using
+// the software backend at the usual update rate, and reports how many lines
+// got through and how long frames took meanwhile.
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eggui.hxx"
+#include "software_backend.hxx"
+
+using namespace eggui;
+
+using std::make_shared;
+using std::make_unique;
+
+constexpr int PRODUCERS = 4;
+constexpr double SECONDS = 2;
+/// Lines each producer appends per second.
+constexpr int LINES_PER_SECOND = 50'000;
+
+int main()
+{
+	using clock = std::chrono::steady_clock;
+
+	auto backend = make_unique<SoftwareBackend>();
+	auto &sw = *backend;
+	set_backend(std::move(backend));
+
+	auto log = make_shared<LogView>(800, 600, 20'000);
+	auto view = make_shared<VScrollView>(800, 600, log);
+
+	// Producers append in bursts, a millisecond worth of lines at a time.
+	std::atomic<bool> stop = false;
+	std::atomic<long> appended = 0;
+	std::vector<std::thread> producers;
+	for (int p = 0; p < PRODUCERS; ++p) {
+		producers.emplace_back([&, p]() {
+			long n = 0;
+			auto next = clock::now();
+			while (!stop) {
+				for (int i = 0; i < LINES_PER_SECOND / 1000; ++i, ++n) {
+					log->append(
+						"worker-" + std::to_string(p) + " event " + std::to_string(n)
+					);
+				}
+				next += std::chrono::milliseconds(1);
+				std::this_thread::sleep_until(next);
+			}
+			appended += n;
+		});
+	}
+
+	// Run the window in real time, sleeping between updates like it would.
+	auto start = clock::now();
+	auto busy = clock::duration::zero();
+	auto last = start;
+	sw.set_poll_callback([&](SoftwareBackend &b) {
+		auto now = clock::now();
+		busy += now - last;
+		std::this_thread::sleep_for(std::chrono::duration<double>(UPDATE_DELTA_TIME)
+		);
+		last = clock::now();
+
+		if (now - start > std::chrono::duration<double>(SECONDS))
+			b.request_close();
+	});
+
+	auto window = Window(view);
+	window.main_loop(820, 600);
+
+	stop = true;
+	for (auto &t : producers)
+		t.join();
+
+	std::chrono::duration<double> busy_time = busy;
+	std::cout << "Appended: " << appended << " lines, "
+			  << appended / SECONDS << " lines/s\n"
+			  << "Dropped: " << log->get_dropped_count() << '\n'
+			  << "Kept: " << log->get_line_count() << '\n'
+			  << "Frames: " << sw.get_frame_count() << ", "
+			  << busy_time.count() * 1e3 / sw.get_frame_count()
+			  << " ms/frame busy\n";
+
+	return 0;
+}
@@ -0,0 +1,105 @@
+// Plots ten million samples run headless using the software backend, while
+// a thread keeps appending more at the usual update rate. Reports the time
+// to the first frame, the time per frame meanwhile and how many column bars
+// are calculated per frame once the first is shown.
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "eggui.hxx"
+#include "software_backend.hxx"
+
+using namespace eggui;
+
+using std::make_shared;
+using std::make_unique;
+
+constexpr long INITIAL_SAMPLES = 10'000'000;
+constexpr double SECONDS = 2;
+/// Samples appended per second.
+constexpr int SAMPLES_PER_SECOND = 1'000'000;
+
+static float sample_at(long i)
+{
+	return std::sin(i * 1e-5) + 0.1 * std::sin(i * 0.37) + (i % 1000 == 0);
+}
+
+int main()
+{
+	using clock = std::chrono::steady_clock;
+
+	auto backend = make_unique<SoftwareBackend>();
+	auto &sw = *backend;
+	set_backend(std::move(backend));
+
+	auto plot = make_shared<Plot>(800, 600, RGBA(25, 162, 10));
+	std::vector<float> values(INITIAL_SAMPLES);
+	for (long i = 0; i < INITIAL_SAMPLES; ++i)
+		values[i] = sample_at(i);
+	plot->append(values);
+
+	// The producer appends a millisecond worth of samples at a time.
+	std::atomic<bool> stop = false;
+	std::thread producer([&]() {
+		std::vector<float> chunk(SAMPLES_PER_SECOND / 1000);
+		long n = INITIAL_SAMPLES;
+		auto next = clock::now();
+		while (!stop) {
+			for (auto &v : chunk)
+				v = sample_at(n++);
+			plot->append(chunk);
+
+			next += std::chrono::milliseconds(1);
+			std::this_thread::sleep_until(next);
+		}
+	});
+
+	// Run the window in real time, sleeping between updates like it would.
+	auto start = clock::now();
+	auto busy = clock::duration::zero();
+	auto last = start;
+	clock::time_point first_frame;
+	long first_columns = 0;
+	sw.set_poll_callback([&](SoftwareBackend &b) {
+		auto now = clock::now();
+		if (b.get_frame_count() == 1) {
+			first_frame = now;
+			first_columns = plot->get_columns_calculated();
+		} else if (b.get_frame_count() > 1) {
+			busy += now - last;
+		}
+
+		std::this_thread::sleep_for(std::chrono::duration<double>(UPDATE_DELTA_TIME)
+		);
+		last = clock::now();
+
+		if (now - start > std::chrono::duration<double>(SECONDS))
+			b.request_close();
+	});
+
+	auto window = Window(plot);
+	window.main_loop(800, 600);
+
+	stop = true;
+	producer.join();
+
+	long frames = sw.get_frame_count() - 1;
+	std::chrono::duration<double> to_first = first_frame - start;
+	std::chrono::duration<double> busy_time = busy;
+	std::cout << "Samples: " << plot->get_sample_count() << '\n'
+			  << "First frame after: " << to_first.count() * 1e3 << " ms, "
+			  << first_columns << " columns\n"
+			  << "Frames after: " << frames << ", "
+			  << busy_time.count() * 1e3 / std::max(1L, frames)
+			  << " ms/frame busy, "
+			  << double(plot->get_columns_calculated() - first_columns)
+					 / std::max(1L, frames)
+			  << " columns/frame\n";
+
+	return 0;
+}
@@ -0,0 +1,171 @@
+// Compares the vectorized rasterizer kernels of the software backend against
+// the scalar ones, in pixels drawn per second for each primitive.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "software_backend.hxx"
+
+using namespace eggui;
+
+constexpr double PI = 3.14159265358979;
+/// Minimum time spent drawing each primitive.
+constexpr double MIN_SECONDS = 0.25;
+constexpr Point WINDOW_SIZE(1024, 768);
+
+struct Primitive {
+	const char *name;
+	DrawCommand cmd;
+	// Pixels covered by the primitive.
+	double pixels;
+};
+
+static DrawCommand make_command(DrawOp op, RGBA color)
+{
+	DrawCommand cmd{.op = op, .color = color};
+	return cmd;
+}
+
+static std::vector<Primitive> make_primitives(int target)
+{
+	// Translucent colors are like the tints used by the theme.
+	const RGBA opaque(80, 80, 80);
+	const RGBA tint(255, 255, 255, 27);
+	const RGBA gap_fill(255, 109, 192, 64);
+	const Point size(256, 128);
+
+	std::vector<Primitive> prims;
+
+	auto rect = make_command(DrawOp::Rect, opaque);
+	rect.points[1] = size;
+	prims.push_back({"rect", rect, double(size.x * size.y)});
+	rect.color = gap_fill;
+	prims.push_back({"rect (translucent)", rect, double(size.x * size.y)});
+
+	auto rounded = make_command(DrawOp::RoundedRect, opaque);
+	rounded.points[1] = size;
+	rounded.params[0] = 0.5;
+	double corner = size.y * 0.5 / 2;
+	double area = size.x * size.y - (4 - PI) * corner * corner;
+	prims.push_back({"rounded rect", rounded, area});
+	rounded.color = tint;
+	prims.push_back({"rounded rect (translucent)", rounded, area});
+
+	auto circle = make_command(DrawOp::Circle, opaque);
+	circle.points[0] = Point(64, 64);
+	circle.params[0] = 64;
+	prims.push_back({"circle", circle, PI * 64 * 64});
+
+	auto ring = make_command(DrawOp::Ring, opaque);
+	ring.points[0] = Point(64, 64);
+	ring.params[0] = 48;
+	ring.params[1] = 64;
+	prims.push_back({"ring", ring, PI * (64 * 64 - 48 * 48)});
+
+	auto image = make_command(DrawOp::RenderTarget, RGBA(255, 255, 255));
+	image.points[1] = size;
+	image.target = target;
+	prims.push_back({"render target", image, double(size.x * size.y)});
+
+	return prims;
+}
+
+/// @brief Draw the primitive repeatedly at different positions.
+/// @return Pixels drawn per second.
+static double measure(SoftwareBackend &b, const Primitive &prim)
+{
+	using clock = std::chrono::steady_clock;
+
+	long draws = 0;
+	auto start = clock::now();
+	std::chrono::duration<double> elapsed{};
+
+	while (elapsed.count() < MIN_SECONDS) {
+		for (int i = 0; i < 100; ++i, ++draws) {
+			auto cmd = prim.cmd;
+			cmd.points[0] += Point(draws * 7 % 512, draws * 5 % 384);
+			b.draw(cmd, nullptr);
+		}
+		elapsed = clock::now() - start;
+	}
+
+	return draws * prim.pixels / elapsed.count();
+}
+
+/// @brief Draw every primitive once onto a cleared window.
+static std::vector<RGBA>
+draw_reference(SoftwareBackend &b, const std::vector<Primitive> &prims)
+{
+	b.clear(RGBA(30, 31, 34));
+	for (int i = 0; i < int(prims.size()); ++i) {
+		auto cmd = prims[i].cmd;
+		cmd.points[0] += Point(i * 97 % 700, i * 61 % 500);
+		b.draw(cmd, nullptr);
+	}
+
+	return b.get_pixels();
+}
+
+int main()
+{
+	SoftwareBackend b;
+	b.open_window(WINDOW_SIZE, "Raster benchmark");
+
+	// A half transparent render target, so that its pixels get blended.
+	int target = b.create_target(Point(256, 128));
+	b.set_target(target);
+	b.clear(RGBA(40, 120, 200, 160));
+	b.set_target(0);
+
+	auto prims = make_primitives(target);
+	auto simd = SoftwareBackend::get_simd_name();
+	if (!simd) {
+		std::cout << "Built without SSE2 or AVX2, only the scalar kernels.\n";
+		simd = "scalar";
+	}
+
+	std::cout << std::left << std::setw(28) << "Primitive" << std::right
+			  << std::setw(16) << "scalar Mpx/s" << std::setw(16) << simd
+			  << " Mpx/s" << std::setw(10) << "speedup\n";
+
+	for (auto &prim : prims) {
+		SoftwareBackend::set_simd_enabled(false);
+		double scalar = measure(b, prim);
+		SoftwareBackend::set_simd_enabled(true);
+		double vector = measure(b, prim);
+
+		std::cout << std::left << std::setw(28) << prim.name << std::right
+				  << std::fixed << std::setprecision(1) << std::setw(16)
+				  << scalar / 1e6 << std::setw(22) << vector / 1e6
+				  << std::setw(9) << vector / scalar << "x\n";
+	}
+
+	// Both kernels must draw the same pixels.
+	SoftwareBackend::set_simd_enabled(false);
+	auto expected = draw_reference(b, prims);
+	SoftwareBackend::set_simd_enabled(true);
+	auto actual = draw_reference(b, prims);
+
+	int max_diff = 0;
+	for (std::size_t i = 0; i < expected.size(); ++i) {
+		auto e = expected[i];
+		auto a = actual[i];
+		max_diff = std::max({
+			max_diff,
+			std::abs(e.r - a.r),
+			std::abs(e.g - a.g),
+			std::abs(e.b - a.b),
+			std::abs(e.a - a.a),
+		});
+	}
+	std::cout << "Max channel difference from scalar output: " << max_diff
+			  << '\n';
+
+	b.destroy_target(target);
+	b.close_window();
+	return max_diff == 0 ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+// Shows a table of a million rows run headless using the software backend,
+// scrolling it and sorting it by a column while it is shown. Reports the time
+// per frame while scrolling, how long the sort takes and the longest frame
+// meanwhile.
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "eggui.hxx"
+#include "software_backend.hxx"
+
+using namespace eggui;
+
+using std::make_shared;
+using std::make_unique;
+
+constexpr int ROWS = 1'000'000;
+constexpr int SCROLL_POLLS = 200;
+
+struct Record {
+	int id;
+	std::uint32_t name;
+	double score;
+	int group;
+};
+
+static std::vector<Record> generate_records()
+{
+	std::vector<Record> records(ROWS);
+	std::uint32_t state = 12345;
+	for (int i = 0; i < ROWS; ++i) {
+		state = state * 1664525 + 1013904223;
+		records[i] = Record{
+			.id = i,
+			.name = state >> 8,
+			.score = (state % 100'000) / 100.,
+			.group = int(state % 37),
+		};
+	}
+
+	return records;
+}
+
+int main()
+{
+	using clock = std::chrono::steady_clock;
+
+	auto records = generate_records();
+
+	auto backend = make_unique<SoftwareBackend>();
+	auto &sw = *backend;
+	set_backend(std::move(backend));
+
+	auto table = make_shared<Table>(
+		780, 600,
+		std::vector<TableColumn>{
+			{.title = "Id", .width = 100},
+			{.title = "Name"},
+			{.title = "Score"},
+			{.title = "Group"},
+		},
+		TableSource{
+			.get_row_count = [&]() { return int(records.size()); },
+			.get_cell =
+				[&](int row, int col) {
+					auto &r = records[row];
+					switch (col) {
+					case 0:
+						return std::to_string(r.id);
+					case 1:
+						return "user-" + std::to_string(r.name);
+					case 2:
+						return std::to_string(r.score);
+					default:
+						return "group " + std::to_string(r.group);
+					}
+				},
+			.less =
+				[&](int col, int a, int b) {
+					auto &ra = records[a];
+					auto &rb = records[b];
+					switch (col) {
+					case 0:
+						return ra.id < rb.id;
+					case 1:
+						return ra.name < rb.name;
+					case 2:
+						return ra.score < rb.score;
+					default:
+						return ra.group < rb.group;
+					}
+				},
+		}
+	);
+	auto view = make_shared<VScrollView>(800, 600, table);
+
+	// Scroll for a while, then sort and keep scrolling until it is sorted.
+	auto last = clock::now();
+	clock::time_point sort_start, sort_end;
+	clock::duration scroll_time{}, longest_sorting{};
+	long sorting_frames = 0;
+	int polls = 0;
+	sw.set_poll_callback([&](SoftwareBackend &b) {
+		auto now = clock::now();
+		auto frame_time = now - last;
+		last = now;
+
+		b.move_mouse(Point(400, 300));
+		b.scroll(Point(0, -20));
+
+		if (++polls <= SCROLL_POLLS) {
+			if (polls > 1)
+				scroll_time += frame_time;
+			if (polls == SCROLL_POLLS) {
+				sort_start = clock::now();
+				table->sort_by(2);
+			}
+		} else if (table->is_sorting()) {
+			sorting_frames++;
+			longest_sorting = std::max(longest_sorting, frame_time);
+		} else {
+			sort_end = clock::now();
+			b.request_close();
+		}
+	});
+
+	auto window = Window(view);
+	window.main_loop(820, 600);
+
+	std::chrono::duration<double> scrolling = scroll_time;
+	std::chrono::duration<double> sorting = sort_end - sort_start;
+	std::chrono::duration<double> longest = longest_sorting;
+	std::cout << "Rows: " << table->get_row_count() << '\n'
+			  << "Scrolling: " << scrolling.count() * 1e3 / (SCROLL_POLLS - 1)
+			  << " ms/frame\n"
+			  << "Sort: " << sorting.count() * 1e3 << " ms, "
+			  << sorting_frames << " frames meanwhile, longest "
+			  << longest.count() * 1e3 << " ms\n"
+			  << "First row: " << table->get_row_at(0) << '\n';
+
+	return 0;
+}
@@ -0,0 +1,102 @@
+// Browses a large tree run headless using the software backend, whose items
+// are made up as they are expanded. Expands and collapses items with many
+// children while many rows are shown, and reports the time taken by that,
+// the number of items loaded and the time per frame while scrolling.
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "eggui.hxx"
+#include "software_backend.hxx"
+
+using namespace eggui;
+
+using std::make_shared;
+using std::make_unique;
+
+/// Children of each item, items at the last level have none.
+constexpr int FANOUT[] = {20, 5'000, 100, 10};
+constexpr int LEVELS = std::size(FANOUT);
+constexpr int POLLS = 400;
+
+/// @brief Make up the children of the item, keys tell the level of items.
+static std::vector<TreeItem> make_children(const TreeItem &parent, long &loaded)
+{
+	int level = parent.key & 0xff;
+	std::vector<TreeItem> items(FANOUT[level]);
+	for (int i = 0; i < FANOUT[level]; ++i) {
+		items[i] = TreeItem{
+			.text = parent.text + "/" + std::to_string(i),
+			.has_children = level + 1 < LEVELS,
+			.key = std::uint64_t(level + 1),
+		};
+	}
+
+	loaded += items.size();
+	return items;
+}
+
+int main()
+{
+	using clock = std::chrono::steady_clock;
+
+	auto backend = make_unique<SoftwareBackend>();
+	auto &sw = *backend;
+	set_backend(std::move(backend));
+
+	long loaded = 0;
+	auto root = TreeItem{.text = "root", .has_children = true, .key = 0};
+	auto tree = make_shared<TreeView>(
+		800, 600, std::vector{root},
+		[&loaded](const TreeItem &parent) {
+			return make_children(parent, loaded);
+		}
+	);
+	auto view = make_shared<VScrollView>(800, 600, tree);
+
+	// Show all the items of the second level, then toggle an item with many
+	// children near the top, with all those rows after it.
+	tree->expand(0);
+	for (int row = tree->get_row_count() - 1; row > 0; --row)
+		tree->expand(row);
+
+	clock::duration toggle_time{}, scroll_time{};
+	int toggles = 0;
+	auto last = clock::now();
+	int polls = 0;
+	sw.set_poll_callback([&](SoftwareBackend &b) {
+		auto now = clock::now();
+		if (polls > 0)
+			scroll_time += now - last;
+
+		auto start = clock::now();
+		tree->toggle(2);
+		toggle_time += clock::now() - start;
+		toggles++;
+
+		b.move_mouse(Point(400, 300));
+		b.scroll(Point(0, -20));
+		last = clock::now();
+
+		if (++polls == POLLS)
+			b.request_close();
+	});
+
+	auto window = Window(view);
+	window.main_loop(820, 600);
+
+	std::chrono::duration<double> toggling = toggle_time;
+	std::chrono::duration<double> scrolling = scroll_time;
+	std::cout << "Rows shown: " << tree->get_row_count()
+			  << ", items loaded: " << loaded << '\n'
+			  << "Expanding or collapsing: "
+			  << toggling.count() * 1e3 / toggles << " ms\n"
+			  << "Frames: " << scrolling.count() * 1e3 / (POLLS - 1)
+			  << " ms/frame\n";
+
+	return 0;
+}
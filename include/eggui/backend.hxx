@@ -0,0 +1,127 @@
+/// Interface to the platform the UI runs on.
+/// A backend creates the window, reports input events and does the actual
+/// drawing, everything else is independent of the backend used.
+
+#ifndef BACKEND_HXX_INCLUDED
+#define BACKEND_HXX_INCLUDED
+
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "point.hxx"
+#include "event.hxx"
+#include "graphics.hxx"
+
+namespace eggui
+{
+class Backend
+{
+public:
+	virtual ~Backend() = default;
+
+	// Window management
+	//---------------------------------------------------------
+	/// @brief Create the window, nothing can be drawn before it.
+	/// @param size Window size.
+	/// @param title Window title.
+	virtual void open_window(Point size, const char *title) = 0;
+	virtual void close_window() = 0;
+	virtual bool is_window_open() const = 0;
+	/// @brief Check if the user has asked to close the window.
+	virtual bool should_close() = 0;
+	/// @brief Check if the window has been resized since the last poll.
+	virtual bool is_resized() = 0;
+
+	virtual Point get_window_size() = 0;
+	/// @brief Get size of the monitor the window is on.
+	virtual Point get_monitor_size() = 0;
+	virtual void set_title(const char *title) = 0;
+	/// @brief Set limits on window size when resized by the user.
+	virtual void set_size_limits(Point min_size, Point max_size) = 0;
+	virtual void set_cursor_shape(CursorShape shape) = 0;
+
+	// Time and events
+	//---------------------------------------------------------
+	/// @brief Get monotonic time in seconds.
+	virtual double get_time() = 0;
+	/// @brief Sleep for the duration.
+	/// @param seconds Duration in seconds.
+	virtual void wait_time(double seconds) = 0;
+	/// @brief Sleep while polling until an input event arrives.
+	/// @param enable Enable or disable waiting.
+	virtual void set_event_waiting(bool enable) = 0;
+	/// @brief Collect input events, the input state is as of the last poll.
+	virtual void poll_events() = 0;
+	/// @brief Stop waiting for an input event, from any thread.
+	virtual void wake() = 0;
+
+	// Input state
+	//---------------------------------------------------------
+	virtual Point get_mouse_position() = 0;
+	/// @brief Get the mouse movement since the last poll.
+	virtual Point get_mouse_delta() = 0;
+	/// @brief Get the mouse wheel movement, in both directions.
+	virtual Point get_mouse_wheel() = 0;
+	/// @brief Check if the left mouse button was pressed since the last poll.
+	virtual bool is_mouse_pressed() = 0;
+	/// @brief Check if the left mouse button was released since the last poll.
+	virtual bool is_mouse_released() = 0;
+	/// @brief Check if the key was pressed since the last poll.
+	virtual bool is_key_pressed(Key key) = 0;
+	/// @brief Take the next key pressed from the queue.
+	/// @return Key::Null if the queue is empty.
+	virtual Key get_key_pressed() = 0;
+	/// @brief Take the next character entered from the queue.
+	/// @return Unicode codepoint, 0 if the queue is empty.
+	virtual int get_char_pressed() = 0;
+
+	// Drawing
+	//---------------------------------------------------------
+	virtual void load_fonts() = 0;
+	virtual void unload_fonts() = 0;
+	/// @brief Get size of the text when drawn without spacing.
+	virtual Point measure_text(const char *text, FontSize font_size) = 0;
+	/// @brief Get horizontal advance of the glyph, a line of text is as wide
+	///        as the advances of its glyphs added up.
+	/// @param codepoint Unicode codepoint.
+	virtual float measure_glyph(int codepoint, FontSize font_size) = 0;
+
+	/// @brief Start drawing a frame on the window.
+	virtual void begin_frame() = 0;
+	/// @brief Show the frame drawn, events are polled as well.
+	virtual void end_frame() = 0;
+
+	/// @brief Fill the whole draw target with the color.
+	virtual void clear(RGBA color) = 0;
+	/// @brief Restrict drawing to the area.
+	/// @param area Start position and size, nullopt for no restriction.
+	virtual void set_clip(std::optional<std::pair<Point, Point>> area) = 0;
+	/// @brief Draw the draw call, its positions are not translated any further.
+	/// @param cmd The draw call, never a DrawOp::Subdraw.
+	/// @param text Text for DrawOp::Text, ignored otherwise.
+	virtual void draw(const DrawCommand &cmd, const char *text) = 0;
+
+	/// @brief Create an offscreen draw target.
+	/// @param size Target size.
+	/// @return Target id, it is positive and ids of destroyed targets may
+	///         be reused. Returns 0 on failure.
+	virtual int create_target(Point size) = 0;
+	virtual void destroy_target(int id) = 0;
+	/// @brief Redirect drawing to the target.
+	/// @param id Target id, 0 for the window.
+	virtual void set_target(int id) = 0;
+};
+
+/// @brief Replace the backend used, raylib is used if none is set.
+/// @param backend The backend.
+/// @note Must be called before the window is created.
+void set_backend(std::unique_ptr<Backend> backend);
+/// @brief Get the backend in use.
+Backend &get_backend();
+
+/// @brief Create a backend which uses raylib, for a window on the desktop.
+std::unique_ptr<Backend> make_raylib_backend();
+} // namespace eggui
+
+#endif
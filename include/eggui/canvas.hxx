@@ -144,5 +144,16 @@ private:
 	Point clip_rect_size{};
 };
 
+/// @brief Get the region which will not be clipped if drawn on right now.
+/// @return Rectangle: position relative to the current translation and size.
+std::pair<Point, Point> get_unclipped_region();
+
+/// @brief Find the rows which will not be clipped if drawn on right now.
+/// @param row_height Height of each row, rows start at the top of the
+///        current translation.
+/// @param count Number of rows.
+/// @return First row and one past the last row.
+std::pair<int, int> calc_visible_rows(int row_height, int count);
+
 } // namespace eggui
 #endif
\ No newline at end of file
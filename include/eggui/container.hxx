@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 #include <utility>
 #include <typeinfo>
@@ -27,13 +28,13 @@ public:
 	/// @brief Calculate layout info but do not actually layout anything.
 	/// @return Minimum size needed for the container to prevent overflow.
 	virtual Point calc_layout_info() = 0;
+	/// @brief Calculate layout info only if it is stale.
+	/// @return Minimum size needed for the container to prevent overflow.
+	Point update_layout_info();
 
+	/// @brief Re-measure and re-layout children, only if the layout is stale
+	///        or the size has changed.
 	void set_size(Point new_size) override;
-
-protected:
-	// Generally a layout calculation needed only when a child is
-	// added or removed from the container or layout config is changed.
-	// bool needs_layout_calc = true;
 };
 
 class PaddedBox : public Container
@@ -42,6 +43,7 @@ public:
 	PaddedBox(std::shared_ptr<Widget> child_)
 		: child(std::move(child_))
 	{
+		child->set_parent(this);
 	}
 
 	/// @brief Set minimum padding for each direction, if a value is negative
@@ -64,6 +66,46 @@ private:
 	int right_pad = 0;
 };
 
+/// @brief Draws its child onto an offscreen render target once, and then
+/// draws that target until something in the child changes or is resized.
+/// Useful for mostly static content like panels of read-only values.
+///
+/// @note If the render target cannot be created within the memory budget,
+/// see `set_render_target_budget`, then the child is drawn directly.
+class CachedBox final : public Container
+{
+public:
+	CachedBox(std::shared_ptr<Widget> child_)
+		: child(std::move(child_))
+	{
+		child->set_parent(this);
+	}
+
+	CachedBox(const CachedBox &) = delete;
+	~CachedBox();
+
+	void layout_children(Point size_hint) override;
+	Point calc_layout_info() override;
+
+protected:
+	Widget *notify(Event ev) override;
+	void draw() override;
+	void draw_debug() override;
+	void on_descendant_damaged() override { is_cache_valid = false; }
+
+private:
+	/// @brief Create the render target if needed and draw onto it if stale.
+	/// @return true if the render target is ready to be drawn.
+	bool update_cache();
+
+	std::shared_ptr<Widget> child;
+
+	// Render target id, 0 if none.
+	int target = 0;
+	Point target_size;
+	bool is_cache_valid = false;
+};
+
 class LinearBox final : public Container
 {
 public:
@@ -75,8 +117,16 @@ public:
 
 	/// @brief Expand the box to fill space available along the orientation.
 	/// @param can_expand Value
-	void set_expand_to_fill(bool can_expand) { expand_to_fill = can_expand; }
-	void set_gap(int gap) { item_gap = gap; }
+	void set_expand_to_fill(bool can_expand)
+	{
+		expand_to_fill = can_expand;
+		invalidate_layout();
+	}
+	void set_gap(int gap)
+	{
+		item_gap = gap;
+		invalidate_layout();
+	}
 
 	Widget *add_widget_start(std::shared_ptr<Widget> child);
 	Widget *add_widget_end(std::shared_ptr<Widget> child);
@@ -128,8 +178,16 @@ class Grid final : public Container
 public:
 	using Container::Container;
 
-	void set_row_gap(int gap) { row_gap = gap; }
-	void set_col_gap(int gap) { col_gap = gap; }
+	void set_row_gap(int gap)
+	{
+		row_gap = gap;
+		invalidate_layout();
+	}
+	void set_col_gap(int gap)
+	{
+		col_gap = gap;
+		invalidate_layout();
+	}
 
 	/// @brief Add widget beside another in the specified direction.
 	/// @param child The widget
@@ -166,6 +224,13 @@ protected:
 
 private:
 	void alloc_row_col_data();
+	/// @brief Grow the table of cell owners to the grid size, keeping the
+	///        owners of existing cells.
+	void grow_cell_owners();
+	/// @brief Check if any cell in the area is occupied by a child.
+	/// @param pos Top left cell: column and row.
+	/// @param span Number of columns and rows.
+	bool is_area_occupied(Point pos, Point span) const;
 
 	struct Child {
 		std::shared_ptr<Widget> widget;
@@ -173,9 +238,19 @@ private:
 		Point grid_pos;
 		// Number of columns and rows spanned.
 		Point span;
+		// The widget if it is a container, found once when added.
+		Container *container;
 	};
 
 	std::vector<Child> children;
+	// Index of each child in `children`, by its widget.
+	std::unordered_map<const Widget *, int> child_indices;
+	// Index of the child occupying each cell, -1 if none. Stored row after
+	// row, `owner_cols` cells each, cells beyond the last column are empty.
+	std::vector<int> cell_owners;
+	// Cells per row in the table of cell owners, it is made again with twice
+	// as many once the grid gets more columns.
+	int owner_cols = 0;
 
 	// The size needed by the largest cell in row/column.
 	std::vector<int> row_sizes;
@@ -195,11 +270,13 @@ private:
 	int col_gap = 0;
 };
 
+/// @brief Calculate layout info for the widget if it is a container and its
+///        layout info is stale, already calculated info is reused otherwise.
 inline void calc_layout_info_if_container(Widget &w)
 {
 	auto cont = dynamic_cast<Container *>(&w);
 	if (cont)
-		cont->calc_layout_info();
+		cont->update_layout_info();
 }
 
 } // namespace eggui
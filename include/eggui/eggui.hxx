@@ -7,10 +7,17 @@
 #include "widget.hxx"
 #include "container.hxx"
 #include "scrollable.hxx"
+#include "list_view.hxx"
+#include "table.hxx"
+#include "tree_view.hxx"
+#include "plot.hxx"
 
 #include "label.hxx"
 
 #include "input.hxx"
+#include "text_editor.hxx"
+#include "file_view.hxx"
+#include "log_view.hxx"
 #include "button.hxx"
 #include "switch.hxx"
 
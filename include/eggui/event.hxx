@@ -28,6 +28,26 @@ enum class EventType {
 	IsInteractive,
 };
 
+/// Keycodes of the KeyPressed events, the values are same as those of raylib.
+enum class Key : int {
+	Null = 0,
+	Space = 32,
+	Escape = 256,
+	Enter = 257,
+	Tab = 258,
+	Backspace = 259,
+	Insert = 260,
+	Delete = 261,
+	Right = 262,
+	Left = 263,
+	Down = 264,
+	Up = 265,
+	PageUp = 266,
+	PageDown = 267,
+	Home = 268,
+	End = 269,
+};
+
 struct Event {
 	Event(Window &win, EventType ev_type, Point cursor_)
 		: window(win)
@@ -51,7 +71,7 @@ struct Event {
 	union {
 		Point delta;
 		Point scroll;
-		// Keycode is dependent on the library used(here raylib).
+		// Value of a Key.
 		int keycode;
 		int char_val;
 	};
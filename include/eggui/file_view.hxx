@@ -0,0 +1,63 @@
+#ifndef FILE_VIEW_HXX_INCLUDED
+#define FILE_VIEW_HXX_INCLUDED
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "widget.hxx"
+#include "graphics.hxx"
+
+namespace eggui
+{
+/// @brief Read-only view of a text file, meant to be put in a VScrollView.
+///
+/// @details
+/// The file is mapped into memory and its lines are found by a background
+/// thread. The view can be scrolled while that goes on, it grows as lines
+/// are found. Only the lines visible in the scroll view are drawn.
+class FileView : public Widget
+{
+public:
+	FileView(int w, int h, FontSize font_size_ = FontSize::Medium);
+	~FileView() override;
+
+	/// @brief Show the file, replacing the one shown earlier.
+	/// @return false if the file could not be read.
+	bool open(const std::string &path);
+	void close();
+
+	/// @brief Check if lines of the file are still being found.
+	bool is_indexing() const;
+	/// @brief Get the number of lines found so far.
+	long get_line_count() const;
+
+protected:
+	void draw() override;
+
+private:
+	// Everything shared with the thread finding lines.
+	struct Index;
+
+	/// @brief Take the lines found by the thread since the last call.
+	/// @return false once all the lines have been taken.
+	bool take_lines();
+	/// @brief Resize the view to fit all the lines found so far, though never
+	///        shorter than it was made.
+	void fit_lines();
+
+	int get_line_height() const { return font_size_to_pixels(font_size); }
+
+	std::unique_ptr<Index> index;
+	// Offset of the start of each line found so far, along with the offset
+	// where the next line would start.
+	std::vector<std::uint64_t> line_starts;
+	bool is_index_complete = true;
+	// Height the view was made with.
+	int min_height;
+	FontSize font_size;
+};
+} // namespace eggui
+
+#endif
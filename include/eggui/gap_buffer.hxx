@@ -0,0 +1,215 @@
+/// Sequence which is cheap to edit around a single position.
+/// Items are stored in one array with a gap in it, the gap is moved to where
+/// items are inserted or erased, so edits close to the previous one only
+/// shift a few items.
+
+#ifndef GAP_BUFFER_HXX_INCLUDED
+#define GAP_BUFFER_HXX_INCLUDED
+
+#include <cassert>
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace eggui
+{
+template <typename T>
+class GapBuffer
+{
+public:
+	using size_type = std::size_t;
+
+	/// @brief Replace all the items, the gap is left at the end.
+	void assign(std::span<const T> items)
+	{
+		buf.assign(items.begin(), items.end());
+		gap_start = gap_end = buf.size();
+	}
+
+	size_type size() const { return buf.size() - (gap_end - gap_start); }
+	bool empty() const { return size() == 0; }
+
+	const T &operator[](size_type i) const
+	{
+		return i < gap_start ? buf[i] : buf[i + gap_end - gap_start];
+	}
+
+	T &operator[](size_type i)
+	{
+		return i < gap_start ? buf[i] : buf[i + gap_end - gap_start];
+	}
+
+	/// @brief Get the position of the gap, items from it onwards are after
+	///        the gap.
+	size_type get_gap_position() const { return gap_start; }
+
+	/// @brief Move the gap in front of the item at the position.
+	void move_gap(size_type pos)
+	{
+		move_gap(pos, [](T &) {});
+	}
+
+	/// @brief Move the gap in front of the item at the position.
+	/// @param on_cross Called with each item moved from one side of the gap
+	///                 to the other, after it is moved.
+	template <typename F>
+	void move_gap(size_type pos, F on_cross)
+	{
+		assert(pos <= size());
+
+		auto gap = gap_end - gap_start;
+		if (pos < gap_start) {
+			std::move_backward(
+				buf.begin() + pos, buf.begin() + gap_start,
+				buf.begin() + gap_end
+			);
+			for (auto i = pos + gap; i < gap_end; ++i)
+				on_cross(buf[i]);
+		} else if (pos > gap_start) {
+			std::move(
+				buf.begin() + gap_end, buf.begin() + pos + gap,
+				buf.begin() + gap_start
+			);
+			for (auto i = gap_start; i < pos; ++i)
+				on_cross(buf[i]);
+		}
+
+		gap_start = pos;
+		gap_end = pos + gap;
+	}
+
+	/// @brief Insert the item before the position, moving the gap there.
+	void insert(size_type pos, const T &item)
+	{
+		move_gap(pos);
+		reserve_gap(1);
+		buf[gap_start++] = item;
+	}
+
+	/// @brief Insert the items before the position, moving the gap there.
+	void insert(size_type pos, std::span<const T> items)
+	{
+		move_gap(pos);
+		reserve_gap(items.size());
+		std::ranges::copy(items, buf.begin() + gap_start);
+		gap_start += items.size();
+	}
+
+	/// @brief Erase items starting at the position, moving the gap there.
+	void erase(size_type pos, size_type count = 1)
+	{
+		assert(pos + count <= size());
+
+		move_gap(pos);
+		gap_end += count;
+	}
+
+	/// @brief Copy the items from the position.
+	/// @param out Destination with room for `count` items.
+	void copy(size_type pos, size_type count, T *out) const
+	{
+		assert(pos + count <= size());
+
+		for (auto end = pos + count; pos < end; ++pos)
+			*out++ = (*this)[pos];
+	}
+
+	/// @brief Get all the items contiguously, by moving the gap to the end.
+	std::span<const T> data()
+	{
+		move_gap(size());
+		return std::span<const T>(buf.data(), gap_start);
+	}
+
+private:
+	/// @brief Grow the gap to fit at least `count` items.
+	void reserve_gap(size_type count)
+	{
+		auto gap = gap_end - gap_start;
+		if (gap >= count)
+			return;
+
+		// Grow geometrically so that inserts are amortized constant time.
+		auto after = buf.size() - gap_end;
+		auto capacity = std::max({size() + count, 2 * buf.size(), MIN_CAPACITY});
+		std::vector<T> grown(capacity);
+
+		std::move(buf.begin(), buf.begin() + gap_start, grown.begin());
+		std::move(buf.begin() + gap_end, buf.end(), grown.end() - after);
+
+		buf = std::move(grown);
+		gap_end = buf.size() - after;
+	}
+
+	static constexpr size_type MIN_CAPACITY = 16;
+
+	// Items before the gap, the gap, then items after it.
+	std::vector<T> buf;
+	// The gap is from `gap_start` to `gap_end`(exclusive).
+	size_type gap_start = 0;
+	size_type gap_end = 0;
+};
+
+/// @brief Increasing positions in a sequence, like starts of lines in a text,
+///        which are kept up to date as the sequence is edited at the gap.
+///
+/// @details
+/// Positions before the gap are stored as they are, and those after it as
+/// distances from the end of the sequence. So growing or shrinking the
+/// sequence at the gap moves all the positions after it at once, and only
+/// positions crossing the gap when it moves need converting.
+template <typename T>
+class PositionBuffer
+{
+public:
+	using size_type = std::size_t;
+
+	/// @brief Replace all the positions, the gap is left at the end.
+	/// @param end_ Position of the end of the sequence.
+	void assign(std::span<const T> positions, T end_)
+	{
+		buf.assign(positions);
+		end = end_;
+	}
+
+	size_type size() const { return buf.size(); }
+	T get_end() const { return end; }
+
+	T operator[](size_type i) const
+	{
+		return i < buf.get_gap_position() ? buf[i] : end - buf[i];
+	}
+
+	size_type get_gap_position() const { return buf.get_gap_position(); }
+
+	/// @brief Move the gap in front of the position at the index.
+	void move_gap(size_type i)
+	{
+		buf.move_gap(i, [this](T &pos) { pos = end - pos; });
+	}
+
+	/// @brief Insert a position before the index, moving the gap there.
+	void insert(size_type i, T pos)
+	{
+		move_gap(i);
+		buf.insert(i, pos);
+	}
+
+	/// @brief Erase positions starting at the index, moving the gap there.
+	void erase(size_type i, size_type count = 1)
+	{
+		move_gap(i);
+		buf.erase(i, count);
+	}
+
+	/// @brief Move the positions after the gap, and the end, by the amount.
+	void shift(T delta) { end += delta; }
+
+private:
+	GapBuffer<T> buf;
+	T end{};
+};
+} // namespace eggui
+
+#endif
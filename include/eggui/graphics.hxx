@@ -4,7 +4,10 @@
 #ifndef GRAPHICS_HXX_INCLUDED
 #define GRAPHICS_HXX_INCLUDED
 
+#include <cstddef>
 #include <cstdint>
+#include <string>
+#include <vector>
 
 #include "point.hxx"
 
@@ -60,6 +63,7 @@ void init_graphics();
 void deinit_graphics();
 
 /// @brief Apply a translation to the drawing position.
+/// Translations can be nested arbitrarily deep.
 /// @param pos Amount to translate.
 void push_translation(Point pos);
 /// @brief Removes the last applied translation.
@@ -107,6 +111,164 @@ void draw_triangle(Point v1, Point v2, Point v3, RGBA color);
 void draw_text(Point position, RGBA color, const char *text, FontSize font_size, int spacing = 0);
 
 Point tell_text_size(const char *text, FontSize font_size);
+// clang-format on
+
+/// @brief Get horizontal advance of the glyph, text is as wide as the
+///        advances of its glyphs added up.
+/// @param codepoint Unicode codepoint.
+/// @param font_size Font size.
+/// @return Advance in pixels.
+float tell_glyph_advance(int codepoint, FontSize font_size);
+
+/// Counters of the cache of text sizes used by `tell_text_size`.
+struct TextCacheStats {
+	// Texts whose size was found in the cache.
+	long hits = 0;
+	// Texts which had to be measured.
+	long misses = 0;
+	// Texts evicted to keep memory used by the cache bounded.
+	long evictions = 0;
+};
+
+/// @brief Get counters of the text size cache.
+TextCacheStats get_text_cache_stats();
+void reset_text_cache_stats();
+
+/// Counters for clip area changes, each change applied flushes the queued
+/// draw calls of the graphics library.
+struct ClipStats {
+	// Clip area changes requested using push/pop.
+	long requested = 0;
+	// Clip area changes actually applied.
+	long applied = 0;
+
+	/// Number of draw call flushes avoided, compared to applying every
+	/// requested change right away.
+	long calc_avoided() const { return requested - applied; }
+};
+
+/// @brief Get counters of clip area changes.
+ClipStats get_clip_stats();
+void reset_clip_stats();
+
+// Offscreen drawing
+// Things can be drawn onto an offscreen render target once and then the
+// target can be drawn as many times as needed.
+//--------------------------------------------------------------
+/// Default limit on memory used by all the render targets together, in bytes.
+constexpr std::size_t DEFAULT_RENDER_TARGET_BUDGET = 64 << 20;
+
+/// @brief Create an offscreen render target.
+/// @param size Target size in pixels.
+/// @return Target id, 0 if it cannot be created within the memory budget.
+int create_render_target(Point size);
+/// @brief Free the render target, does nothing if already freed.
+/// @param id Target id.
+/// @note `deinit_graphics` frees all the render targets.
+void destroy_render_target(int id);
+
+/// @brief Redirect drawing to the render target, translations and clipping
+///        start afresh for it. Must be paired with `end_render_target`.
+/// @param id Target id.
+/// @note The target is cleared to the background color.
+void begin_render_target(int id);
+/// @brief Stop drawing to the render target started last.
+void end_render_target();
+
+/// @brief Draw contents of the render target.
+/// @param position Position of the top-left corner.
+/// @param id Target id.
+void draw_render_target(Point position, int id);
+
+/// @brief Set limit on memory used by all the render targets together.
+/// @param bytes Budget in bytes, existing targets are not freed.
+void set_render_target_budget(std::size_t bytes);
+/// @brief Get memory used by all the render targets together.
+/// @return Usage in bytes.
+std::size_t get_render_target_usage();
+
+// Retained drawing
+// Draw calls can be recorded into a draw list and replayed later, so that
+// things which have not changed need not be drawn from scratch.
+//--------------------------------------------------------------
+/// Draw operation of a recorded draw call.
+enum class DrawOp : std::uint8_t {
+	Pixel,
+	Line,
+	Rect,
+	RectLines,
+	RoundedRect,
+	Circle,
+	CircleSector,
+	Ring,
+	Triangle,
+	Text,
+	RenderTarget,
+	Subdraw,
+};
+
+/// @brief A draw call along with its arguments.
+/// Meaning of `points` and `params` depends on the operation, they are
+/// stored in the same order as the arguments of the draw function.
+struct DrawCommand {
+	DrawOp op;
+	FontSize font_size = FontSize::Medium;
+	RGBA color = RGBA(0, 0, 0);
+	Point points[3]{};
+	float params[3]{};
+	// Text position in the text buffer of the draw list.
+	std::uint32_t text_at = 0;
+	// Render target id for DrawOp::RenderTarget.
+	int target = 0;
+	// Sub-draw callback and its argument.
+	void (*subdraw)(void *) = nullptr;
+	void *subdraw_arg = nullptr;
+};
+
+/// @brief Recorded draw calls which can be replayed.
+class DrawList
+{
+public:
+	/// @brief Remove all the recorded draw calls.
+	void clear();
+	bool is_empty() const { return commands.empty(); }
+
+	/// @brief Append a draw call.
+	/// @param cmd The draw call.
+	/// @param text Text for DrawOp::Text, ignored otherwise.
+	void add(DrawCommand cmd, const char *text = nullptr);
+	/// @brief Draw all the recorded draw calls again, in the same order.
+	void replay() const;
+
+private:
+	std::vector<DrawCommand> commands;
+	// Null terminated texts of the text draw calls, stored back to back.
+	std::string texts;
+};
+
+/// @brief Start recording draw calls into the list, recorded draw calls are
+///        also drawn as usual. Recordings can be nested.
+/// @param list Draw list, new calls are appended to it.
+void begin_recording(DrawList &list);
+/// @brief Stop the last recording started.
+void end_recording();
+/// @brief Check if draw calls are being recorded.
+/// @return boolean
+bool is_recording();
+
+/// @brief Start collecting draw calls into batches instead of drawing them
+///        right away. Draw calls are grouped by clip area and graphics state,
+///        while keeping the order of the draw calls which overlap.
+/// @note Translation must not be applied when batching starts and ends.
+void begin_batching();
+/// @brief Draw all the batched draw calls with fewest state changes.
+void end_batching();
+
+/// @brief Draw using a callback, while recording only the callback itself is
+///        recorded, not the draw calls it makes.
+/// @param draw_fn Callback which does the drawing, like for a child widget.
+/// @param arg Argument passed to the callback.
+void draw_subdraw(void (*draw_fn)(void *), void *arg);
 } // namespace eggui
 
 #endif
@@ -28,9 +28,14 @@ public:
 	{
 		h_align = halign;
 		v_align = valign;
+		mark_damaged();
 	}
 
-	void set_color(RGBA color_) { color = color_; }
+	void set_color(RGBA color_)
+	{
+		color = color_;
+		mark_damaged();
+	}
 	void set_text(std::string txt);
 
 protected:
@@ -0,0 +1,106 @@
+#ifndef LIST_VIEW_HXX_INCLUDED
+#define LIST_VIEW_HXX_INCLUDED
+
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "widget.hxx"
+#include "container.hxx"
+#include "graphics.hxx"
+
+namespace eggui
+{
+/// @brief Where a list view gets its items from.
+struct ListSource {
+	/// @brief Get the number of items.
+	std::function<int()> get_count;
+	/// @brief Create a widget showing an item, bound to items later.
+	std::function<std::shared_ptr<Widget>()> make_row;
+	/// @brief Make the widget show the item at the index.
+	std::function<void(Widget &row, int index)> bind_row;
+};
+
+/// @brief List of items with rows of equal height, meant to be put in a
+///        VScrollView.
+///
+/// @details
+/// Only enough row widgets to cover the visible part of the list, plus a few
+/// rows of overscan on either side, are created. As the list is scrolled, the
+/// rows which went out of sight are bound to the items coming into it, so
+/// memory and time per frame do not depend on the number of items. Like in
+/// a Table, rows are placed by how far the list is scrolled, so a list of
+/// more items than fit in the height it can have still shows all of them.
+class ListView final : public Container
+{
+public:
+	ListView(int w, int row_height_, ListSource source_);
+
+	/// @brief Set the number of rows kept bound beyond each end of the
+	///        visible part, so that they are ready before being scrolled to.
+	void set_overscan(int rows);
+
+	/// @brief Get the number of items, as of the last refresh.
+	int get_item_count() const { return item_count; }
+	/// @brief Get the number of row widgets created.
+	int get_row_count() const { return rows.size(); }
+
+	/// @brief Take in a changed number of items and bind all shown rows
+	///        again, call when the items have changed.
+	void refresh();
+
+	/// @brief Scroll so that the item is visible.
+	void scroll_to_item(int index);
+
+	void set_position(Point new_pos) override;
+	void layout_children(Point size_hint) override;
+	Point calc_layout_info() override;
+
+protected:
+	Widget *notify(Event ev) override;
+	void draw() override;
+	void draw_debug() override;
+
+private:
+	struct Row {
+		std::shared_ptr<Widget> widget;
+		// Index of the item bound, -1 if none.
+		int index = -1;
+	};
+
+	/// @brief Find the items which should be bound right now.
+	/// @param place Place of the item at the top, as found by
+	///        VScrollView::calc_first_row.
+	/// @param view_len Length of the part of the list shown.
+	/// @return Index range [first, last) of items.
+	std::pair<int, int> calc_shown_items(double place, int view_len) const;
+	/// @brief Find the item whose row is at the position, it may be outside
+	///        of the items bound.
+	int find_item_at(int ypos) const;
+	/// @brief Bind rows to the items which are shown, creating rows if there
+	///        are not enough.
+	void update_rows();
+	/// @brief Size the row to the width of the list.
+	void fit_row(Widget &row);
+
+	/// @brief Get the row an item is bound to, when it is shown.
+	Row &row_for(int index) { return rows[index % rows.size()]; }
+
+	ListSource source;
+	// Rows are reused in a ring, item i being bound to row i % rows.size(),
+	// so rows for items scrolled past are the ones bound to new items.
+	std::vector<Row> rows;
+	// Items bound to rows right now, [first, last).
+	int first_shown = 0;
+	int last_shown = 0;
+	// Position of the row of the first item bound, the rest follow it.
+	int first_ypos = 0;
+
+	int item_count = 0;
+	int row_height;
+	int overscan = 4;
+};
+} // namespace eggui
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef LOG_VIEW_HXX_INCLUDED
+#define LOG_VIEW_HXX_INCLUDED
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "widget.hxx"
+#include "graphics.hxx"
+
+namespace eggui
+{
+/// @brief View of the latest lines of a log, meant to be put in a
+///        VScrollView. Lines can be appended from any thread.
+///
+/// @details
+/// Appended lines go through a lock-free queue, and appending wakes the
+/// window, which takes them out of it on its next update. Only the latest
+/// `max_lines` lines are kept, and only the visible ones are drawn. While
+/// scrolled to the end, the view keeps following the latest lines.
+class LogView : public Widget
+{
+public:
+	/// @param max_lines_ Number of lines kept, the queue of appended lines
+	///                   holds at least as many.
+	LogView(
+		int w, int h, std::size_t max_lines_ = 10000,
+		FontSize font_size_ = FontSize::Small
+	);
+	~LogView() override;
+
+	/// @brief Append a line, from any thread. Lines longer than can be
+	///        shown are cut short.
+	/// @return false if the line was dropped, since the view has not kept
+	///         up with the lines appended.
+	bool append(std::string line);
+
+	/// @brief Remove all the lines taken in so far.
+	void clear();
+
+	/// @brief Get the number of lines kept.
+	std::size_t get_line_count() const { return lines.size(); }
+	/// @brief Get the number of lines dropped since the queue was full.
+	long get_dropped_count() const;
+
+	/// @brief Keep scrolling to the latest lines while scrolled to the end.
+	void set_follow_tail(bool enable) { follow_tail = enable; }
+
+protected:
+	void draw() override;
+
+private:
+	// The queue appended lines go through, shared with other threads.
+	struct Incoming;
+
+	/// @brief Take in the lines appended since the last call.
+	/// @return true if lines are left to take on the next update.
+	bool take_lines();
+	/// @brief Resize the view to fit all the lines, though never
+	///        shorter than it was made.
+	void fit_lines();
+
+	int get_line_height() const { return font_size_to_pixels(font_size); }
+
+	std::unique_ptr<Incoming> incoming;
+	// Lines kept, oldest first.
+	std::deque<std::string> lines;
+	std::size_t max_lines;
+	bool follow_tail = true;
+	// Height the view was made with.
+	int min_height;
+	FontSize font_size;
+};
+} // namespace eggui
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef PLOT_HXX_INCLUDED
+#define PLOT_HXX_INCLUDED
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "widget.hxx"
+#include "graphics.hxx"
+
+namespace eggui
+{
+/// @brief Line plot of a series of samples, which can be appended to from
+///        any thread.
+///
+/// @details
+/// When more samples are shown than there are pixel columns, the samples of
+/// each column are reduced to their minimum and maximum, and a bar spanning
+/// them is drawn per column. So at most one primitive per pixel column is
+/// drawn, however many samples are shown.
+///
+/// Bars are cached for each zoom level, that is the number of samples per
+/// column, with columns starting at multiples of it. Appended samples only
+/// change the columns at the end, so only those are calculated again.
+class Plot : public Widget
+{
+public:
+	Plot(int w, int h, RGBA color_);
+	~Plot() override;
+
+	/// @brief Append samples, from any thread.
+	void append(std::span<const float> values);
+	/// @brief Remove all the samples.
+	void clear();
+	/// @brief Get the number of samples taken in so far.
+	std::size_t get_sample_count() const { return samples.size(); }
+
+	/// @brief Show all the samples, including those appended later.
+	void show_all();
+	/// @brief Show the latest samples, following those appended later.
+	void show_latest(std::size_t count);
+	/// @brief Show the samples in the range [first, first + count).
+	void show_range(std::size_t first, std::size_t count);
+
+	/// @brief Fix the range of values shown.
+	void set_value_range(float low, float high);
+	/// @brief Fit the range of values shown to the samples shown.
+	void fit_value_range();
+
+	/// @brief Get the number of column bars calculated so far, for telling
+	///        how well they are cached.
+	long get_columns_calculated() const { return columns_calculated; }
+
+protected:
+	void draw() override;
+
+private:
+	// Samples appended and not yet taken, shared with other threads.
+	struct Incoming;
+
+	// Bars for all the columns of a zoom level.
+	struct Level {
+		std::vector<float> mins;
+		std::vector<float> maxs;
+		// Samples the bars were calculated from.
+		std::size_t sample_count = 0;
+		long last_used = 0;
+	};
+
+	enum class Range {
+		All,
+		Latest,
+		Fixed,
+	};
+
+	/// @brief Take in the samples appended since the last call.
+	void take_samples();
+
+	/// @brief Find the samples shown right now.
+	/// @return First sample and the number of samples.
+	std::pair<std::size_t, std::size_t> calc_shown_samples() const;
+
+	/// @brief Calculate bars for columns [first, last) of the zoom level.
+	void calc_columns(
+		std::size_t per_column, std::size_t first, std::size_t last,
+		float *mins, float *maxs
+	);
+	/// @brief Get the bars of the zoom level, calculating those which are
+	///        missing or stale.
+	Level &get_level(std::size_t per_column);
+
+	void draw_samples(std::size_t first, std::size_t count);
+	void draw_columns(std::size_t first, std::size_t count);
+
+	/// @brief Map a value to the y-position it is drawn at.
+	float value_to_ypos(float value, float low, float high) const;
+
+	std::unique_ptr<Incoming> incoming;
+	std::vector<float> samples;
+
+	// Levels cached, by the number of samples per column.
+	std::map<std::size_t, Level> levels;
+	long use_count = 0;
+	long columns_calculated = 0;
+	// Bars of columns calculated on each draw, for levels not cached.
+	std::vector<float> scratch_mins;
+	std::vector<float> scratch_maxs;
+
+	Range range = Range::All;
+	std::size_t range_first = 0;
+	std::size_t range_count = 0;
+
+	bool is_value_range_fixed = false;
+	float value_low = 0;
+	float value_high = 1;
+
+	RGBA color;
+};
+} // namespace eggui
+
+#endif
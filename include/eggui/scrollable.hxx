@@ -81,6 +81,37 @@ public:
 	void layout_children(Point size_hint) override;
 	Point calc_layout_info() override;
 
+	/// @brief Scroll by as little as needed to show a part of the child.
+	/// @param start Start of the part, relative to the child.
+	/// @param len Length of the part.
+	void scroll_into_view(int start, int len);
+
+	// Children with a huge number of rows, more than fit in the height
+	// children can have, place their rows by how far they are scrolled
+	// rather than by their position in them.
+	//---------------------------------------------------------
+	/// @brief Calculate the height of the rows, capped at the height
+	///        scrolling is still precise to a pixel at.
+	static int calc_rows_height(long long row_count, int row_height);
+	/// @brief Find the part of the widget shown by the scroll view it is in,
+	///        all of it if it is not in one.
+	/// @return Top and length of the part shown.
+	static std::pair<int, int> calc_shown_span(const Widget &w);
+	/// @brief Find the row drawn at the top of the part shown.
+	/// @param top Top of the part shown, as found by calc_shown_span.
+	/// @param view_len Length of the part shown.
+	/// @param height Height of the rows, as found by calc_rows_height.
+	/// @return Place of the row, with the fraction of it scrolled past.
+	static double calc_first_row(
+		int top, int view_len, int height, long row_count, int row_height
+	);
+	/// @brief Find the top of the part shown at which the place is drawn at
+	///        the top, the reverse of calc_first_row.
+	/// @return Top, within how far the rows can be scrolled.
+	static double calc_row_top(
+		double place, int view_len, int height, long row_count, int row_height
+	);
+
 protected:
 	Widget *notify(Event ev) override;
 	void draw() override;
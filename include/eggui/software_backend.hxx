@@ -0,0 +1,166 @@
+#ifndef SOFTWARE_BACKEND_HXX_INCLUDED
+#define SOFTWARE_BACKEND_HXX_INCLUDED
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "backend.hxx"
+#include "constants.hxx"
+
+namespace eggui
+{
+/// @brief Backend which draws into an in-memory RGBA framebuffer, without
+///        any display. Used for benchmarks and golden image tests.
+///
+/// @details
+/// Input is simulated by the program through the methods below, it is seen by
+/// the widgets from the next poll onwards. Time is simulated too, it advances
+/// only by waiting, so that runs are repeatable and never sleep.
+///
+/// Text is drawn as one box per visible character using fixed glyph metrics,
+/// so that images do not depend on font rasterization.
+class SoftwareBackend final : public Backend
+{
+public:
+	/// @param monitor_size_ Size of the simulated monitor, which limits the
+	///        window size.
+	explicit SoftwareBackend(Point monitor_size_ = Point(1920, 1080))
+		: monitor_size(monitor_size_)
+	{
+	}
+
+	// Framebuffer access
+	//---------------------------------------------------------
+	/// @brief Get the window pixels, stored row after row.
+	const std::vector<RGBA> &get_pixels() const { return window.pixels; }
+	RGBA get_pixel(Point pos) const;
+	/// @brief Get number of frames shown till now.
+	long get_frame_count() const { return frame_count; }
+
+	/// @brief Choose between the vectorized(SSE2/AVX2) and the scalar
+	///        rasterizer kernels, vectorized ones are used if compiled in.
+	static void set_simd_enabled(bool enable);
+	/// @brief Get the instruction set used for rasterizing.
+	/// @return nullptr if the scalar kernels are used.
+	static const char *get_simd_name();
+
+	// Input simulation
+	//---------------------------------------------------------
+	void move_mouse(Point pos) { pending.mouse_pos = pos; }
+	void press_mouse() { pending.mouse_pressed = true; }
+	void release_mouse() { pending.mouse_released = true; }
+	void scroll(Point amount) { pending.wheel += amount; }
+	void press_key(Key key) { pending.keys.push_back(key); }
+	void enter_char(int codepoint) { pending.chars.push_back(codepoint); }
+	/// @brief Resize the window like the user would, the size is clamped to
+	///        the size limits.
+	void resize_window(Point size) { pending.window_size = size; }
+	/// @brief Ask to close the window like the user would.
+	void request_close() { close_requested = true; }
+	/// @brief Set a callback called at the start of each poll, it can be used
+	///        to feed input frame by frame and to end the main loop.
+	void set_poll_callback(std::function<void(SoftwareBackend &)> callback)
+	{
+		poll_callback = std::move(callback);
+	}
+
+	// Backend interface
+	//---------------------------------------------------------
+	void open_window(Point size, const char *title) override;
+	void close_window() override { is_open = false; }
+	bool is_window_open() const override { return is_open; }
+	bool should_close() override { return close_requested; }
+	bool is_resized() override { return resized; }
+
+	Point get_window_size() override { return window.size; }
+	Point get_monitor_size() override { return monitor_size; }
+	void set_title(const char *) override {}
+	void set_size_limits(Point min_size, Point max_size) override;
+	void set_cursor_shape(CursorShape) override {}
+
+	double get_time() override { return time; }
+	void wait_time(double seconds) override { time += seconds; }
+	void set_event_waiting(bool) override {}
+	void poll_events() override;
+	void wake() override {}
+
+	Point get_mouse_position() override { return current.mouse_pos; }
+	Point get_mouse_delta() override { return mouse_delta; }
+	Point get_mouse_wheel() override { return current.wheel; }
+	bool is_mouse_pressed() override { return current.mouse_pressed; }
+	bool is_mouse_released() override { return current.mouse_released; }
+	bool is_key_pressed(Key key) override;
+	Key get_key_pressed() override;
+	int get_char_pressed() override;
+
+	void load_fonts() override {}
+	void unload_fonts() override {}
+	Point measure_text(const char *text, FontSize font_size) override;
+	float measure_glyph(int codepoint, FontSize font_size) override;
+
+	void begin_frame() override {}
+	void end_frame() override;
+
+	void clear(RGBA color) override;
+	void set_clip(std::optional<std::pair<Point, Point>> area) override
+	{
+		clip_area = area;
+	}
+	void draw(const DrawCommand &cmd, const char *text) override;
+
+	int create_target(Point size) override;
+	void destroy_target(int id) override;
+	void set_target(int id) override;
+
+private:
+	struct Framebuffer {
+		Point size = Point(0, 0);
+		std::vector<RGBA> pixels;
+	};
+
+	/// Input received between two polls.
+	struct Input {
+		Point mouse_pos = Point(0, 0);
+		Point wheel = Point(0, 0);
+		bool mouse_pressed = false;
+		bool mouse_released = false;
+		std::vector<Key> keys;
+		std::vector<int> chars;
+		std::optional<Point> window_size;
+	};
+
+	Framebuffer &get_framebuffer();
+	void resize_framebuffer(Framebuffer &fb, Point size);
+
+	Point monitor_size;
+	// Limits on window size when resized.
+	Point min_window_size = Point(1, 1);
+	Point max_window_size = Point(UNLIMITED_MAX_SIZE, UNLIMITED_MAX_SIZE);
+
+	Framebuffer window;
+	// Offscreen targets indexed by id - 1, freed ones have zero size.
+	std::vector<Framebuffer> targets;
+	int current_target = 0;
+	std::optional<std::pair<Point, Point>> clip_area;
+
+	bool is_open = false;
+	bool close_requested = false;
+	bool resized = false;
+	double time = 0;
+	long frame_count = 0;
+
+	// Input to be seen from the next poll, and input seen since the last one.
+	Input pending;
+	Input current;
+	Point mouse_delta = Point(0, 0);
+	// Keys and chars taken from the queues of current input.
+	std::size_t keys_taken = 0;
+	std::size_t chars_taken = 0;
+	std::function<void(SoftwareBackend &)> poll_callback;
+};
+} // namespace eggui
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef TABLE_HXX_INCLUDED
+#define TABLE_HXX_INCLUDED
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "widget.hxx"
+#include "graphics.hxx"
+
+namespace eggui
+{
+struct TableColumn {
+	std::string title;
+	/// Width in pixels, 0 to fit the title and the cells of the first rows.
+	int width = 0;
+};
+
+/// @brief Where a table gets its rows from.
+///
+/// @note Large tables are sorted on other threads, which call `get_cell`
+/// or `less` while the table is shown. The rows must not change until the
+/// table is refreshed, and reading them must be safe from several threads.
+struct TableSource {
+	/// @brief Get the number of rows.
+	std::function<int()> get_row_count;
+	/// @brief Get the text of a cell.
+	std::function<std::string(int row, int col)> get_cell;
+	/// @brief Compare the cells of two rows in a column for sorting, cell
+	///        texts are compared if not given.
+	std::function<bool(int col, int row_a, int row_b)> less;
+};
+
+/// @brief Table of text cells with a header, meant to be put in a
+///        VScrollView.
+///
+/// @details
+/// Cells are drawn straight from the source, only those visible in the
+/// scroll view, so no widgets are made for them. The header stays at the
+/// top of the view, clicking a column title sorts the rows by it. Rows are
+/// sorted through a permutation of their indices, on several threads off
+/// the UI thread for large tables, showing the rows in their last order
+/// until the sort is done.
+class Table : public Interactive
+{
+public:
+	Table(
+		int w, int h, std::vector<TableColumn> columns_, TableSource source_,
+		FontSize font_size_ = FontSize::Small
+	);
+	~Table() override;
+
+	/// @brief Take in changed rows, sorting them again if they were sorted.
+	void refresh();
+
+	/// @brief Sort the rows by the column, -1 to show them unsorted.
+	void sort_by(int col, bool ascending = true);
+	/// @brief Get the column rows are sorted by, or being sorted by.
+	int get_sort_column() const { return sort_column; }
+	bool is_sort_ascending() const { return sort_ascending; }
+	/// @brief Check if rows are still being sorted, on other threads.
+	bool is_sorting() const;
+
+	int get_row_count() const { return row_count; }
+	/// @brief Get the row shown at the place, counting from the top.
+	int get_row_at(int place) const;
+	/// @brief Find the place of the row under the point, -1 if none.
+	int find_place(Point pos) const;
+
+protected:
+	Widget *notify(Event ev) override;
+	void draw() override;
+
+private:
+	// Everything shared with the threads sorting the rows.
+	struct Sorter;
+
+	/// @brief Start sorting by the column asked for, or apply the order
+	///        right away for small tables.
+	void start_sort();
+	/// @brief Take the order from a sort which is done.
+	/// @return false once no sort is running.
+	bool take_order();
+
+	/// @brief Calculate widths of columns which fit their cells, and widen
+	///        the table to fit all the columns.
+	void fit_columns();
+	/// @brief Resize the table to fit all the rows.
+	void fit_rows();
+
+	/// @brief Find the place of the row drawn at the top of the part shown,
+	///        right below the header.
+	double calc_first_place(int top, int view_len) const;
+
+	int get_row_height() const;
+
+	std::vector<TableColumn> columns;
+	TableSource source;
+	int row_count = 0;
+
+	std::vector<int> col_widths;
+	std::vector<int> col_offsets;
+	int content_width = 0;
+
+	// Index of the row shown at each place.
+	std::vector<int> order;
+	// Sort asked for, `order` is sorted like that once no sort is running.
+	int sort_column = -1;
+	bool sort_ascending = true;
+	std::unique_ptr<Sorter> sorter;
+
+	// Size the table was made with, it grows beyond it to fit its columns
+	// and rows.
+	Point base_size;
+	FontSize font_size;
+};
+} // namespace eggui
+
+#endif
@@ -10,6 +10,7 @@
 
 #include "widget.hxx"
 #include "graphics.hxx"
+#include "gap_buffer.hxx"
 
 namespace eggui
 {
@@ -34,6 +35,7 @@ public:
 	/// @return The actual amount(delta) cursor was moved.
 	int move_cursor(int delta);
 	void insert_before_cursor(char c);
+	void insert_before_cursor(std::string_view str);
 	void delete_before_cursor();
 	void delete_after_cursor();
 
@@ -42,16 +44,33 @@ protected:
 	void draw() override;
 
 private:
-	void calc_cursor_offset();
+	/// @brief Calculate x-positions of all the characters from scratch.
+	void calc_char_positions();
+	/// @brief Get x-position of the character, or the text width for the
+	///        position past the end.
+	double get_char_xpos(int i) const { return char_xpos[i]; }
+	/// @brief Find the cursor position closest to the x-position.
+	/// @param xpos X-position relative to the start of text.
+	int find_cursor_at(double xpos) const;
+	/// @brief Calculate text offset, needed for scrolling it on overflow.
+	/// @return Horizontal offset, always <= 0.
+	double calc_x_offset() const;
+	/// @brief Calculate cursor rectangle relative to the text box.
+	/// @return Rectangle: position and size.
+	std::pair<Point, Point> calc_cursor_rect() const;
 
-	// Text value
-	std::string text;
+	// Text value, edited at the cursor. Mutable since reading it whole moves
+	// the gap out of the way.
+	mutable GapBuffer<char> text;
 	// Text filter function, only keep the input char if it returns true.
 	std::function<bool(char)> filter_predicate = [](char) { return true; };
 	// Region of the text which is selected(if any). Range is [low, high).
 	std::optional<std::pair<int, int>> selected_range;
-	// Calculated cursor offset from the begining of text in pixels.
-	float cursor_xpos = 0;
+	// X-position of each character from the begining of text in pixels,
+	// followed by the text width. These are prefix sums of glyph advances,
+	// kept as doubles so that they stay exact to a fraction of a pixel in
+	// texts megabytes long.
+	PositionBuffer<double> char_xpos;
 	// Cursor position within the text.
 	int cursor_at = 0;
 	// Cursor opacity: 0-255(inclusive)
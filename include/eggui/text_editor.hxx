@@ -0,0 +1,109 @@
+#ifndef TEXT_EDITOR_HXX_INCLUDED
+#define TEXT_EDITOR_HXX_INCLUDED
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "widget.hxx"
+#include "graphics.hxx"
+#include "gap_buffer.hxx"
+
+namespace eggui
+{
+/// @brief Multi-line text editor, meant to be put in a VScrollView.
+///
+/// @details
+/// The editor is as tall as all of its lines, but only the lines visible in
+/// the scroll view are measured and drawn. Starts of lines are indexed, and
+/// the index is updated as the text is edited at the cursor, so that edits
+/// and scrolling cost the same regardless of the text length.
+/// Text is edited bytewise, with the cursor kept between UTF-8 characters.
+class TextEditor : public Interactive
+{
+public:
+	TextEditor(
+		int w, int h, std::string txt = "",
+		FontSize font_size_ = FontSize::Medium
+	);
+
+	void set_text(std::string txt);
+	/// @brief Get the whole text, it stays valid until the text is edited.
+	std::string_view get_text() const;
+
+	int get_line_count() const { return line_starts.size(); }
+	/// @brief Get the text of the line, without the line break.
+	std::string get_line(int line) const;
+	/// @brief Find the line the text offset is in.
+	int find_line(int offset) const;
+
+	/// @brief Move the cursor to the offset in text.
+	/// @param keep_selection Extend the selection to the new position,
+	///                       instead of removing it.
+	void set_cursor(int offset, bool keep_selection = false);
+	int get_cursor() const { return cursor_at; }
+	/// @brief Move cursor by characters, clamped to the text.
+	void move_cursor(int delta, bool keep_selection = false);
+	/// @brief Move cursor by lines, keeping its x-position if possible.
+	void move_cursor_lines(int delta, bool keep_selection = false);
+
+	/// @brief Select the text in range, the cursor is moved to its end.
+	void select(int start, int end);
+	/// @brief Get the selected range as [start, end), empty if none.
+	std::pair<int, int> get_selection() const;
+	std::string get_selected_text() const;
+
+	/// @brief Insert the text at the cursor, replacing the selection.
+	void insert(std::string_view str);
+	/// @brief Delete the selection, or the character before the cursor.
+	void delete_before_cursor();
+	/// @brief Delete the selection, or the character after the cursor.
+	void delete_after_cursor();
+
+protected:
+	Widget *notify(Event ev) override;
+	void draw() override;
+
+private:
+	/// @brief Delete the text in range [start, end), moving the cursor to
+	///        the start.
+	void erase(int start, int end);
+	/// @brief Delete the selection, if any.
+	/// @return false if nothing was selected.
+	bool erase_selection();
+
+	int get_line_height() const { return font_size_to_pixels(font_size); }
+	/// @brief Get the offset of the end of the line, before its line break.
+	int get_line_end(int line) const;
+	/// @brief Calculate x-position of the offset in its line.
+	float calc_xpos(int offset) const;
+	/// @brief Find the offset in the line closest to the x-position.
+	int find_offset(int line, float xpos) const;
+	/// @brief Find the offset closest to the position in the editor.
+	int find_offset(Point pos) const;
+
+	/// @brief Resize the editor to fit all the lines, though never
+	///        shorter than it was made.
+	void fit_lines();
+	/// @brief Scroll the enclosing VScrollView so that the cursor is visible.
+	void scroll_to_cursor();
+
+	// Text value, edited at the cursor. Mutable since reading it whole moves
+	// the gap out of the way.
+	mutable GapBuffer<char> text;
+	// Offset of the start of each line in the text.
+	PositionBuffer<int> line_starts;
+	// Cursor position within the text.
+	int cursor_at = 0;
+	// The other end of the selection, same as the cursor if none.
+	int anchor_at = 0;
+	// X-position to keep while moving the cursor up and down, if any.
+	float goal_xpos = -1;
+	// Height the editor was made with.
+	int min_height;
+	bool is_focused = false;
+	FontSize font_size;
+};
+} // namespace eggui
+
+#endif
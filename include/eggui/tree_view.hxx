@@ -0,0 +1,111 @@
+#ifndef TREE_VIEW_HXX_INCLUDED
+#define TREE_VIEW_HXX_INCLUDED
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "widget.hxx"
+#include "graphics.hxx"
+
+namespace eggui
+{
+/// @brief Item of a tree view, as given by its source.
+struct TreeItem {
+	std::string text;
+	/// Whether the item may have children, it can be expanded if so.
+	bool has_children = false;
+	/// Value kept for the source, to tell which item to get children of.
+	std::uint64_t key = 0;
+};
+
+/// @brief Get the children of the item, called once when it is first
+///        expanded.
+using TreeLoader = std::function<std::vector<TreeItem>(const TreeItem &)>;
+
+/// @brief Tree of text items, meant to be put in a VScrollView.
+///
+/// @details
+/// Children of an item are got from the loader only once the item is first
+/// expanded. Rows shown are kept in a flat array, each pointing to its node,
+/// so drawing and scrolling only visit the rows in sight. Expanding or
+/// collapsing an item inserts or removes the rows of its shown descendants
+/// right after it, the other rows are left as they are.
+///
+/// Clicking the marker before an item expands or collapses it, clicking
+/// anywhere on a row selects it. Up and down move the selection, right and
+/// left expand and collapse the selected item.
+class TreeView : public Interactive
+{
+public:
+	TreeView(
+		int w, int h, std::vector<TreeItem> roots, TreeLoader load_children_,
+		FontSize font_size_ = FontSize::Small
+	);
+	~TreeView() override;
+
+	/// @brief Get the number of rows shown, one for each item whose
+	///        ancestors are all expanded.
+	int get_row_count() const { return rows.size(); }
+	const TreeItem &get_item(int row) const;
+	/// @brief Get the number of ancestors of the item on the row.
+	int get_depth(int row) const;
+	bool is_expanded(int row) const;
+
+	/// @brief Show the children of the item on the row, loading them if it
+	///        was never expanded.
+	void expand(int row);
+	/// @brief Hide the descendants of the item on the row.
+	void collapse(int row);
+	void toggle(int row);
+
+	/// @brief Select the row, -1 to select none.
+	void select_row(int row);
+	/// @brief Get the selected row, -1 if none.
+	int get_selected_row() const { return selected_row; }
+
+protected:
+	Widget *notify(Event ev) override;
+	void draw() override;
+
+private:
+	struct Node;
+
+	/// @brief Make nodes for the items, at the depth given.
+	static std::vector<std::unique_ptr<Node>> make_nodes(
+		std::vector<TreeItem> items, int depth
+	);
+	/// @brief Add rows of the node and its shown descendants to `out`.
+	static void collect_rows(Node &node, std::vector<Node *> &out);
+	/// @brief Find the end of the rows of the shown descendants of the row.
+	int find_subtree_end(int row) const;
+
+	/// @brief Find the row at the position, -1 if none.
+	int find_row(Point pos) const;
+	/// @brief Get the x-position where the text of the row starts, the
+	///        marker for expanding is drawn right before it.
+	int calc_text_xpos(int row) const;
+
+	/// @brief Resize the view to fit all the rows, though never
+	///        shorter than it was made.
+	void fit_rows();
+	/// @brief Scroll the enclosing VScrollView so that the row is visible.
+	void scroll_to_row(int row);
+
+	int get_row_height() const { return font_size_to_pixels(font_size); }
+
+	std::vector<std::unique_ptr<Node>> roots;
+	// Nodes shown, in the order shown.
+	std::vector<Node *> rows;
+	TreeLoader load_children;
+	int selected_row = -1;
+	// Height the view was made with.
+	int min_height;
+	bool is_focused = false;
+	FontSize font_size;
+};
+} // namespace eggui
+
+#endif
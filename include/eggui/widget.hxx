@@ -57,6 +57,8 @@ public:
 	virtual void set_size(Point new_size);
 	inline Point get_size() const { return canvas.get_size(); }
 
+	// Changing size constraints does not invalidate the layout by itself,
+	// since containers set them on themselves while calculating layout info.
 	inline void set_min_size(Point size) { min_box_size = size; }
 	inline Point get_min_size() const { return min_box_size; }
 
@@ -75,7 +77,12 @@ public:
 
 	/// @brief Set parent of the widget.
 	/// @param w Parent widget, it is generally a container.
-	inline void set_parent(Widget *w) { parent = w; }
+	inline void set_parent(Widget *w)
+	{
+		parent = w;
+		position_generation++;
+		note_tree_changed();
+	}
 	inline Widget *get_parent() const { return parent; }
 
 	/// @brief Move the widget along with its children
@@ -86,15 +93,35 @@ public:
 	void set_xpos(int x) { set_position(Point(x, get_position().y)); }
 	void set_ypos(int y) { set_position(Point(get_position().x, y)); }
 
-	void set_vert_align(Alignment alignment) { v_align = alignment; }
+	void set_vert_align(Alignment alignment)
+	{
+		v_align = alignment;
+		invalidate_layout();
+	}
 	Alignment get_vert_align() const { return v_align; }
 
-	void set_horiz_align(Alignment alignment) { h_align = alignment; }
+	void set_horiz_align(Alignment alignment)
+	{
+		h_align = alignment;
+		invalidate_layout();
+	}
 	Alignment get_horiz_align() const { return h_align; }
 
-	void set_fill(Fill fill_mode) { fill = fill_mode; }
+	void set_fill(Fill fill_mode)
+	{
+		fill = fill_mode;
+		invalidate_layout();
+	}
 	Fill get_fill() const { return fill; }
 
+	/// @brief Mark layout of the widget and all of its ancestors as stale,
+	///        so that they are re-measured and re-placed on next layout.
+	/// @note Call it after changing size constraints of a laid out widget.
+	void invalidate_layout();
+	/// @brief Check if the widget needs to be laid out again.
+	/// @return true if the layout is stale.
+	bool needs_layout() const { return needs_relayout; }
+
 	/// @brief Checks if the `point` is inside the widget.
 	/// @param point Cursor position relative to the widget's parent.
 	/// @return Boolean.
@@ -105,23 +132,69 @@ public:
 
 	/// @brief Calculates the absolute position of the widget on the screen.
 	/// @return Point
+	/// @note It is cached until some widget is moved, then calculated again
+	///       from the cached position of the parent.
 	Point calc_abs_position() const;
 
+	/// @brief Report that the widget needs to be redrawn, only the damaged
+	///        areas of the window are redrawn.
+	void mark_damaged() { mark_damaged(Point(0, 0), get_size()); }
+	/// @brief Report that a part of the widget needs to be redrawn.
+	/// @param start Area start position relative to the widget.
+	/// @param size Area size.
+	void mark_damaged(Point start, Point size);
+
+	/// @brief Enable retained drawing, the drawing is recorded once and then
+	///        replayed until the widget is damaged or resized.
+	/// @param enable Value
+	/// @note Only use it for widgets which mark themselves damaged whenever
+	///       something they draw changes.
+	void set_retained(bool enable);
+	bool is_retained() const { return retained; }
+
 	/// @brief Checks if the widget is visible on the screen if drawn using
 	///        the provided pen.
 	/// @param pen Pen
 	/// @return true if visible, false otherwise.
 	bool is_visible(const Pen &pen) const;
 
+	/// @brief Get the generation of the widget tree, it changes whenever a
+	///        widget is moved, resized, reparented, enabled or disabled.
+	/// @note The widget found under the cursor stays the same until it does.
+	static unsigned long get_tree_generation() { return tree_generation; }
+
 protected:
+	/// @brief Report a change which may change the widget under the cursor.
+	static void note_tree_changed() { tree_generation++; }
+
+	/// @brief Resize to the height and keep it, for widgets as tall as their
+	///        content. It is resized right away, and laid out again.
+	void set_fixed_height(int height);
+
 	/// @brief Does the event handling, called by `notify_widget`.
 	virtual Widget *notify(Event) { return nullptr; }
 	/// @brief Draws stuff, called by `draw_widget`.
 	virtual void draw() = 0;
 	/// @brief Draws debug boxes, called by `draw_widget_debug`.
 	virtual void draw_debug();
+	/// @brief Called when a descendant of the widget marks itself damaged.
+	virtual void on_descendant_damaged() {}
+
+	// Layout state, both are set by `invalidate_layout` and cleared once the
+	// widget has been laid out by `set_size`. If a widget has stale layout
+	// then all of its ancestors also have stale layout.
+	// Size constraints need to be calculated again(containers only).
+	bool needs_layout_calc = true;
+	// Children need to be placed again even if the size stays the same.
+	bool needs_relayout = true;
 
 private:
+	/// Shared by all the widgets, since the window hit tests the whole tree.
+	inline static unsigned long tree_generation = 0;
+	/// Changes whenever any widget is moved or reparented, absolute
+	/// positions cached before it changes are stale.
+	inline static unsigned long position_generation = 1;
+
 	/// Parent widget, at a time a widget can have only one parent.
 	Widget *parent = nullptr;
 	// Position relative to the parent and size of the widget are the same as
@@ -139,9 +212,19 @@ private:
 	// Fill mode for excess size inside a container
 	Fill fill = Fill::RowNColumn;
 
+	// Absolute position, valid while `position_generation` stays at
+	// `abs_position_generation`.
+	mutable Point abs_position;
+	mutable unsigned long abs_position_generation = 0;
+
 	/// Keeps track of whether the drawing will be visible or not,
 	/// only valid after we start drawing. For debugging purposes only.
 	bool is_drawing_visible = false;
+
+	// Retained drawing state, the draw list is recorded only if enabled.
+	bool retained = false;
+	bool is_draw_list_valid = false;
+	DrawList draw_list;
 };
 
 /// @brief Abstract base class for interactable widgets.
@@ -150,8 +233,16 @@ class Interactive : public Widget
 public:
 	using Widget::Widget;
 
-	void disable() { is_disabled_ = true; }
-	void enable() { is_disabled_ = false; }
+	void disable()
+	{
+		is_disabled_ = true;
+		note_tree_changed();
+	}
+	void enable()
+	{
+		is_disabled_ = false;
+		note_tree_changed();
+	}
 	bool is_disabled() const { return is_disabled_; }
 
 protected:
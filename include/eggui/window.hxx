@@ -79,8 +79,10 @@ public:
 private:
 	/// @brief Update all the widgets by sending events to them.
 	void update();
-	/// @brief Draw the window.
+	/// @brief Draw the damaged areas of the window.
 	void draw();
+	/// @brief Draw all the widgets, anything outside the clip area is skipped.
+	void draw_widgets();
 
 	/// @brief Layout the widgets.
 	/// @param size Size of the window for layout.
@@ -90,13 +92,18 @@ private:
 
 	/// @brief Handle mouse related events.
 	void handle_mouse_events();
+	/// @brief Find the interactive widget under the cursor, reusing the last
+	///        probe if neither the cursor nor the widget tree have changed.
+	/// @return The overlay under the cursor(or the root widget), and the
+	///         widget hovered inside of it.
+	std::pair<Widget *, Widget *> probe_hovered();
 	/// @brief Handle key press events.
 	void handle_keyboard_events();
 	/// @brief Play all the animations and manage them
 	void play_animations();
 
 	/// @brief Send event to the widget along with current cursor position
-	/// and record(as `draw_cnt > 0`) if the widget responded.
+	/// and mark the widget which responded as damaged.
 	/// @return The widget which responded to the event.
 	Widget *notify_n_ack(Widget *w, EventType type, Point extra = Point(0, 0));
 	/// @brief Send scroll(if any) to the widget.
@@ -119,8 +126,10 @@ private:
 	bool debug_borders_enabled = false;
 	// Is sleep to wait for input events enabled.
 	bool event_waiting_enabled = false;
-	// Number of times widgets should be drawn after a change.
+	// Number of times the whole window should be drawn after a change.
 	int draw_cnt = 1;
+	// Screen areas drawn in the last frame as start position and size.
+	std::vector<std::pair<Point, Point>> last_drawn_areas;
 	// Monotonic time when update was last called.
 	double last_update_time = 0;
 
@@ -129,6 +138,13 @@ private:
 	// Widget over which the cursor is placed, if a mouse button has been
 	// pressed over an interactive widget then, it will be same as `mouse_down_over`.
 	Widget *hovering_over = nullptr;
+	// Last hover probe, valid while the cursor stays at `probed_cursor` and
+	// the widget tree generation stays at `probed_generation`.
+	bool is_probe_valid = false;
+	Point probed_cursor;
+	unsigned long probed_generation = 0;
+	Widget *probed_target = nullptr;
+	Widget *probed_hovered = nullptr;
 	// Widget over which keyboard is focused, all keypressed will to sent to it.
 	Widget *focused_on = nullptr;
 	/// Do not remove focus until explicitly changed/removed by request_focus.
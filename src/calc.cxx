@@ -1,12 +1,117 @@
 #include <cassert>
 #include <algorithm>
+#include <cstddef>
 #include <vector>
 
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 #include "calc.hxx"
 #include "widget.hxx"
 
 namespace eggui
 {
+/// @brief Add up the lengths, grids may have thousands of rows.
+static int sum_lengths(const std::vector<int> &lengths)
+{
+	const int *data = lengths.data();
+	std::size_t n = lengths.size();
+	std::size_t i = 0;
+	int sum = 0;
+
+#if defined(__AVX2__)
+	auto vsum = _mm256_setzero_si256();
+	for (; i + 8 <= n; i += 8) {
+		auto chunk = _mm256_loadu_si256((const __m256i *)(data + i));
+		vsum = _mm256_add_epi32(vsum, chunk);
+	}
+
+	alignas(32) int sums[8];
+	_mm256_store_si256((__m256i *)sums, vsum);
+	for (int v : sums)
+		sum += v;
+#elif defined(__SSE2__)
+	auto vsum = _mm_setzero_si128();
+	for (; i + 4 <= n; i += 4) {
+		auto chunk = _mm_loadu_si128((const __m128i *)(data + i));
+		vsum = _mm_add_epi32(vsum, chunk);
+	}
+
+	alignas(16) int sums[4];
+	_mm_store_si128((__m128i *)sums, vsum);
+	for (int v : sums)
+		sum += v;
+#endif
+
+	for (; i < n; ++i)
+		sum += data[i];
+
+	return sum;
+}
+
+/// @brief Expand each box from its minimum by `increment` times the amount
+///        it can expand, truncated.
+/// @return Total length of the boxes expanded.
+static int expand_lengths(
+	const std::vector<int> &min_sizes, const std::vector<int> &max_sizes,
+	double increment, std::vector<int> &result
+)
+{
+	const int *mins = min_sizes.data();
+	const int *maxs = max_sizes.data();
+	int *out = result.data();
+	std::size_t n = result.size();
+	std::size_t i = 0;
+	int total = 0;
+
+#if defined(__AVX2__)
+	auto vinc = _mm256_set1_pd(increment);
+	auto vtotal = _mm_setzero_si128();
+	for (; i + 4 <= n; i += 4) {
+		auto vmin = _mm_loadu_si128((const __m128i *)(mins + i));
+		auto vmax = _mm_loadu_si128((const __m128i *)(maxs + i));
+		auto extra = _mm256_cvtepi32_pd(_mm_sub_epi32(vmax, vmin));
+		auto len = _mm256_add_pd(
+			_mm256_cvtepi32_pd(vmin), _mm256_mul_pd(vinc, extra)
+		);
+		auto vlen = _mm256_cvttpd_epi32(len);
+		_mm_storeu_si128((__m128i *)(out + i), vlen);
+		vtotal = _mm_add_epi32(vtotal, vlen);
+	}
+
+	alignas(16) int totals[4];
+	_mm_store_si128((__m128i *)totals, vtotal);
+	for (int v : totals)
+		total += v;
+#elif defined(__SSE2__)
+	auto vinc = _mm_set1_pd(increment);
+	auto vtotal = _mm_setzero_si128();
+	for (; i + 2 <= n; i += 2) {
+		auto vmin = _mm_loadl_epi64((const __m128i *)(mins + i));
+		auto vmax = _mm_loadl_epi64((const __m128i *)(maxs + i));
+		auto extra = _mm_cvtepi32_pd(_mm_sub_epi32(vmax, vmin));
+		auto len = _mm_add_pd(_mm_cvtepi32_pd(vmin), _mm_mul_pd(vinc, extra));
+		auto vlen = _mm_cvttpd_epi32(len);
+		_mm_storel_epi64((__m128i *)(out + i), vlen);
+		vtotal = _mm_add_epi32(vtotal, vlen);
+	}
+
+	alignas(16) int totals[4];
+	_mm_store_si128((__m128i *)totals, vtotal);
+	for (int v : totals)
+		total += v;
+#endif
+
+	for (; i < n; ++i) {
+		int extra = maxs[i] - mins[i];
+		out[i] = mins[i] + increment * extra;
+		total += out[i];
+	}
+
+	return total;
+}
+
 Point calc_align_offset(
 	Point child_size, Point cont_size, Alignment halign, Alignment valign
 )
@@ -75,14 +180,8 @@ void calc_expanded_size(
 	assert(min_sizes.size() == max_sizes.size());
 	result.resize(min_sizes.size());
 
-	int min_size = 0;
-	for (auto v : min_sizes)
-		min_size += v;
-
-	int max_size = 0;
-	for (auto v : max_sizes)
-		max_size += v;
-
+	int min_size = sum_lengths(min_sizes);
+	int max_size = sum_lengths(max_sizes);
 	int usable_size = std::min(max_size, avail_size);
 
 	// If none of the boxes can be expanded then just set it to zero.
@@ -90,13 +189,8 @@ void calc_expanded_size(
 	if (int diff = max_size - min_size; diff > 0)
 		increment = 1.0 * (usable_size - min_size) / diff;
 
-	int unused_size = usable_size;
-	for (unsigned i = 0; i < min_sizes.size(); ++i) {
-		int extra = max_sizes[i] - min_sizes[i];
-		double actual = min_sizes[i] + increment * extra;
-		result[i] = min_sizes[i] + increment * extra;
-		unused_size -= result[i];
-	}
+	int unused_size = usable_size
+					  - expand_lengths(min_sizes, max_sizes, increment, result);
 
 	// Since conversion to int truncates the fractional part we add the
 	// remaining unused size so that we use all the usable space.
@@ -108,10 +202,6 @@ void calc_expanded_size(
 
 int calc_length_with_gaps(const std::vector<int> &lengths, int gap)
 {
-	int sum = 0;
-	for (auto v : lengths)
-		sum += v;
-
-	return sum + gap * (lengths.size() - 1);
+	return sum_lengths(lengths) + gap * (lengths.size() - 1);
 };
 } // namespace eggui
@@ -1,6 +1,6 @@
 #include <cassert>
-
-#include "raylib/raylib.h"
+#include <algorithm>
+#include <utility>
 
 #include "canvas.hxx"
 #include "graphics.hxx"
@@ -32,6 +32,20 @@ void Canvas::set_draw_region(Point rect_start, Point rect_size)
 	region_size = rect_size;
 }
 
+std::pair<Point, Point> eggui::get_unclipped_region()
+{
+	auto [pos, size] = ClippingManager::instance().get_current_clip_region();
+	return {pos - get_total_translation(), size};
+}
+
+std::pair<int, int> eggui::calc_visible_rows(int row_height, int count)
+{
+	auto [clip_pos, clip_size] = get_unclipped_region();
+	int first = std::clamp(clip_pos.y / row_height, 0, count);
+	int last = (clip_pos.y + clip_size.y) / row_height + 1;
+	return {first, std::clamp(last, first, count)};
+}
+
 // Pen class members
 //---------------------------------------------------------
 Pen::Pen(Canvas &canvas_, bool is_clipping_)
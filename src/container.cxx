@@ -10,6 +10,7 @@
 #include "graphics.hxx"
 #include "theme.hxx"
 #include "calc.hxx"
+#include "utils/range_max.hxx"
 
 namespace ranges = std::ranges;
 namespace views = std::views;
@@ -19,11 +20,67 @@ using namespace eggui;
 using std::pair;
 using std::vector;
 
+/// @brief Get the area of the container which is visible right now.
+/// @return Rectangle relative to the container. While recording the whole
+/// container, since the recording may be replayed with another clip area.
+static pair<Point, Point> get_visible_area(const Widget &w)
+{
+	if (is_recording())
+		return {Point(0, 0), w.get_size()};
+	return get_unclipped_region();
+}
+
+/// @brief Find the range of cells which overlap the span [start, end).
+/// @param offsets Cell offsets, in ascending order.
+/// @param sizes Cell sizes.
+/// @return Index range [first, last) of overlapping cells.
+static pair<int, int> find_cells_in_span(
+	const vector<int> &offsets, const vector<int> &sizes, int start, int end
+)
+{
+	auto index = views::iota(0, int(offsets.size()));
+	auto first = ranges::partition_point(index, [&](int i) {
+		return offsets[i] + sizes[i] <= start;
+	});
+	auto last = ranges::partition_point(index, [&](int i) {
+		return offsets[i] < end;
+	});
+
+	int first_at = first - index.begin();
+	int last_at = last - index.begin();
+	return pair(first_at, std::max(first_at, last_at));
+}
+
+/// @brief Find the last cell starting at or before the position.
+/// @param offsets Cell offsets, in ascending order.
+/// @return Index of the cell, -1 if the position is before all of them.
+static int find_cell_at(const vector<int> &offsets, int pos)
+{
+	auto it = ranges::upper_bound(offsets, pos);
+	return int(it - offsets.begin()) - 1;
+}
+
 // Container members
 //---------------------------------------------------------
+Point Container::update_layout_info()
+{
+	if (needs_layout_calc) {
+		calc_layout_info();
+		needs_layout_calc = false;
+	}
+
+	return get_min_size();
+}
+
 void Container::set_size(Point new_size)
 {
-	calc_layout_info();
+	update_layout_info();
+
+	// Children remain where they are if nothing changed within the subtree.
+	auto size = clamp_components(new_size, get_min_size(), get_max_size());
+	if (!needs_relayout && size == get_size())
+		return;
+
 	layout_children(new_size);
 }
 
@@ -35,6 +92,7 @@ void PaddedBox::set_padding(int top, int bottom, int left, int right)
 	right_pad = right < 0 ? right_pad : right;
 	top_pad = top < 0 ? top_pad : top;
 	bottom_pad = bottom < 0 ? bottom_pad : bottom;
+	invalidate_layout();
 }
 
 void PaddedBox::layout_children(Point size_hint)
@@ -81,6 +139,90 @@ void PaddedBox::draw_debug()
 	draw_widget_debug(*child);
 }
 
+// CachedBox members
+//---------------------------------------------------------
+CachedBox::~CachedBox()
+{
+	if (target)
+		destroy_render_target(target);
+}
+
+void CachedBox::layout_children(Point size_hint)
+{
+	size_hint = clamp_components(size_hint, get_min_size(), get_max_size());
+
+	auto child_size = calc_stretched_size(
+		child->get_min_size(), child->get_max_size(), size_hint,
+		child->get_fill()
+	);
+
+	child->set_position(Point(0, 0));
+	child->set_size(child_size);
+	Widget::set_size(size_hint);
+
+	// Something within the child may have moved.
+	is_cache_valid = false;
+}
+
+Point CachedBox::calc_layout_info()
+{
+	calc_layout_info_if_container(*child);
+
+	set_min_size(child->get_min_size());
+	set_max_size(child->get_max_size());
+	return get_min_size();
+}
+
+Widget *CachedBox::notify(Event ev)
+{
+	if (child->collides_with_point(ev.cursor))
+		return notify_widget(*child, ev);
+	return nullptr;
+}
+
+void CachedBox::draw()
+{
+	// A recording would hold on to the target even after it becomes stale.
+	if (is_recording() || !update_cache()) {
+		draw_widget(*child);
+		return;
+	}
+
+	draw_render_target(Point(0, 0), target);
+}
+
+void CachedBox::draw_debug()
+{
+	Widget::draw_debug();
+	draw_widget_debug(*child);
+}
+
+bool CachedBox::update_cache()
+{
+	if (target && target_size != get_size()) {
+		destroy_render_target(target);
+		target = 0;
+	}
+
+	if (!target) {
+		target = create_render_target(get_size());
+		target_size = get_size();
+		is_cache_valid = false;
+	}
+
+	if (!target)
+		return false;
+
+	if (!is_cache_valid) {
+		begin_render_target(target);
+		draw_widget(*child);
+		end_render_target();
+		is_cache_valid = true;
+	}
+
+	return true;
+}
+
 // LinearBox members
 //---------------------------------------------------------
 Widget *LinearBox::add_widget_start(std::shared_ptr<Widget> child)
@@ -94,6 +236,7 @@ Widget *LinearBox::add_widget_start(std::shared_ptr<Widget> child)
 		.fill = Fill::RowNColumn,
 	});
 
+	invalidate_layout();
 	return start_children.back().widget.get();
 }
 
@@ -108,11 +251,31 @@ Widget *LinearBox::add_widget_end(std::shared_ptr<Widget> child)
 		.fill = Fill::RowNColumn,
 	});
 
+	invalidate_layout();
 	return end_children.back().widget.get();
 }
 
 Widget *LinearBox::notify(Event ev)
 {
+	const auto count = start_children.size() + end_children.size();
+	const int axis = static_cast<int>(orientation);
+
+	// Cells are in ascending order of their offsets, so only the child in
+	// the cell under the cursor may collide with it.
+	if (cell_offsets.size() == count) {
+		int i = find_cell_at(cell_offsets, ev.cursor[axis]);
+		if (i < 0)
+			return nullptr;
+
+		const int start_cnt = start_children.size();
+		auto &w = i < start_cnt ? *start_children[i].widget
+								: *end_children[count - 1 - i].widget;
+		if (!w.collides_with_point(ev.cursor))
+			return nullptr;
+		return notify_widget(w, ev);
+	}
+
+	// Not laid out yet.
 	for (auto &c : start_children) {
 		if (c.widget->collides_with_point(ev.cursor))
 			return notify_widget(*c.widget, ev);
@@ -162,10 +325,33 @@ void LinearBox::draw_debug()
 
 void LinearBox::draw()
 {
-	for (auto &c : start_children)
-		draw_widget(*c.widget);
-	for (auto &c : end_children)
-		draw_widget(*c.widget);
+	const auto count = start_children.size() + end_children.size();
+	const int axis = static_cast<int>(orientation);
+
+	// Not laid out yet.
+	if (cell_offsets.size() != count) {
+		for (auto &c : start_children)
+			draw_widget(*c.widget);
+		for (auto &c : end_children)
+			draw_widget(*c.widget);
+		return;
+	}
+
+	// Cells are placed in ascending order of their offsets, so we only visit
+	// the cells which lie in the visible area.
+	auto [pos, size] = get_visible_area(*this);
+	auto [first, last] = find_cells_in_span(
+		cell_offsets, cell_sizes, pos[axis], pos[axis] + size[axis]
+	);
+
+	// First come start children and then end children in reverse order.
+	const int start_cnt = start_children.size();
+	for (int i = first; i < last; ++i) {
+		if (i < start_cnt)
+			draw_widget(*start_children[i].widget);
+		else
+			draw_widget(*end_children[count - 1 - i].widget);
+	}
 }
 
 void LinearBox::layout_children(Point size_hint)
@@ -284,12 +470,11 @@ Widget *Grid::add_widget_beside(
 	assert(row_span > 0);
 	assert(column_span > 0);
 
-	auto sibling = std::ranges::find_if(children, [beside](Child &c) {
-		return c.widget.get() == beside;
-	});
-	if (sibling == children.end())
+	auto found = child_indices.find(beside);
+	if (found == child_indices.end())
 		return nullptr;
 
+	auto sibling = &children[found->second];
 	auto gpos = sibling->grid_pos;
 
 	if (has_component(stick, Direction::Top))
@@ -323,10 +508,8 @@ Widget *Grid::add_widget(
 	Point span(column_span, row_span);
 
 	// Newly added widget should not overlap with existing ones.
-	for (auto &c : children) {
-		if (check_box_collision(pos, span, c.grid_pos, c.span))
-			return nullptr;
-	}
+	if (is_area_occupied(pos, span))
+		return nullptr;
 
 	// Extend the grid if its too small for the widget.
 	auto end = pos + span;
@@ -342,13 +525,83 @@ Widget *Grid::add_widget(
 		.widget = std::move(child),
 		.grid_pos = pos,
 		.span = span,
+		.container = dynamic_cast<Container *>(ret_ptr),
 	});
 
+	int index = children.size() - 1;
+	child_indices[ret_ptr] = index;
+
+	grow_cell_owners();
+	for (int r = pos.y; r < end.y; ++r) {
+		auto cells = cell_owners.begin() + r * owner_cols;
+		std::fill(cells + pos.x, cells + end.x, index);
+	}
+
+	invalidate_layout();
 	return ret_ptr;
 }
 
+void Grid::grow_cell_owners()
+{
+	// Rows are twice as long as needed once made again, so that adding
+	// columns one by one takes linear time overall.
+	if (owner_cols < col_count) {
+		int cols = std::max(col_count, 2 * owner_cols);
+		int rows = owner_cols ? cell_owners.size() / owner_cols : 0;
+
+		std::vector<int> owners(rows * cols, -1);
+		for (int r = 0; r < rows; ++r) {
+			auto cells = cell_owners.begin() + r * owner_cols;
+			std::copy(cells, cells + owner_cols, owners.begin() + r * cols);
+		}
+
+		cell_owners = std::move(owners);
+		owner_cols = cols;
+	}
+
+	// Adding rows only adds cells at the end.
+	if (int(cell_owners.size()) < row_count * owner_cols)
+		cell_owners.resize(row_count * owner_cols, -1);
+}
+
+bool Grid::is_area_occupied(Point pos, Point span) const
+{
+	// Cells beyond the grid are not occupied by anyone.
+	int last_col = std::min(pos.x + span.x, col_count);
+	int last_row = std::min(pos.y + span.y, row_count);
+	for (int r = pos.y; r < last_row; ++r) {
+		for (int c = pos.x; c < last_col; ++c) {
+			if (cell_owners[r * owner_cols + c] >= 0)
+				return true;
+		}
+	}
+
+	return false;
+}
+
 Widget *Grid::notify(Event ev)
 {
+	// Only the child occupying the cell under the cursor may collide with
+	// it, gaps are taken as part of the cells before them.
+	bool is_laid_out = int(col_offsets.size()) == col_count
+					   && int(row_offsets.size()) == row_count;
+	if (is_laid_out) {
+		int col = find_cell_at(col_offsets, ev.cursor.x);
+		int row = find_cell_at(row_offsets, ev.cursor.y);
+		if (col < 0 || row < 0)
+			return nullptr;
+
+		int owner = cell_owners[row * owner_cols + col];
+		if (owner < 0)
+			return nullptr;
+
+		auto &w = *children[owner].widget;
+		if (!w.collides_with_point(ev.cursor))
+			return nullptr;
+		return notify_widget(w, ev);
+	}
+
+	// Not laid out yet.
 	for (auto &c : children) {
 		if (!c.widget->collides_with_point(ev.cursor))
 			continue;
@@ -393,8 +646,34 @@ void Grid::draw_debug()
 
 void Grid::draw()
 {
-	for (auto &c : children)
-		draw_widget(*c.widget);
+	// Find the rows and columns which are visible, and only draw widgets
+	// which lie in them.
+	auto [pos, size] = get_visible_area(*this);
+	auto [col_first, col_last] = find_cells_in_span(
+		col_offsets, col_sizes, pos.x, pos.x + size.x
+	);
+	auto [row_first, row_last] = find_cells_in_span(
+		row_offsets, row_sizes, pos.y, pos.y + size.y
+	);
+
+	// Walk the visible cells, skipping past each child once found. A child
+	// is drawn on the first visible row it occupies, either its own first
+	// row or the first visible one if it starts above.
+	for (int r = row_first; r < row_last; ++r) {
+		auto cells = cell_owners.begin() + r * owner_cols;
+		for (int c = col_first; c < col_last;) {
+			int owner = cells[c];
+			if (owner < 0) {
+				c++;
+				continue;
+			}
+
+			auto &child = children[owner];
+			if (child.grid_pos.y == r || r == row_first)
+				draw_widget(*child.widget);
+			c = child.grid_pos.x + child.span.x;
+		}
+	}
 }
 
 void Grid::layout_children(Point size_hint)
@@ -424,7 +703,7 @@ void Grid::layout_children(Point size_hint)
 	// Cell(s) may become larger than the widget due to another widget in the
 	// same row/column having larger size.
 	// Then stretch accordingly and layout each child.
-	for (auto &[w, grid_pos, span] : children) {
+	for (auto &[w, grid_pos, span, container] : children) {
 		auto [start, end] = pair(grid_pos, grid_pos + span);
 		end -= Point(1, 1);
 		Point avail_size(
@@ -453,18 +732,28 @@ Point Grid::calc_layout_info()
 {
 	alloc_row_col_data();
 
-	// We do layout calculation for inner containers but do not actually
-	// layout their children, since doing that requires size available
-	// for the container which we not have right now.
-	for (auto &c : children)
-		calc_layout_info_if_container(*c.widget);
-
 	// Calculate minimum and maximum size of each row and column.
 	// If a widget spans multiple cells then, we also need to consider the
 	// gaps between each cell for calculating cell size, since it will span
 	// those gaps too. For that we simply remove the amount of size it spans
 	// on gaps and only use the remaining size for cells.
+	// All the cells spanned are raised at once, so that widgets spanning
+	// many cells take no longer than others.
+	RangeMax col_mins, col_maxs, row_mins, row_maxs;
+	col_mins.reset(col_count);
+	col_maxs.reset(col_count);
+	row_mins.reset(row_count);
+	row_maxs.reset(row_count);
+
+	// Each child is visited once, since visiting thousands of them costs
+	// a cache miss each.
 	for (auto &c : children) {
+		// We do layout calculation for inner containers but do not actually
+		// layout their children, since doing that requires size available
+		// for the container which we not have right now.
+		if (c.container)
+			c.container->update_layout_info();
+
 		auto max_size = c.widget->get_max_size();
 		auto min_size = c.widget->get_min_size();
 
@@ -480,16 +769,17 @@ Point Grid::calc_layout_info()
 		int cell_h_max = max_size.y / c.span.y;
 
 		auto [start, end] = pair(c.grid_pos, c.grid_pos + c.span);
-		for (int i = start.x; i < end.x; ++i) {
-			col_min_sizes[i] = std::max(col_min_sizes[i], cell_w_min);
-			col_max_sizes[i] = std::max(col_max_sizes[i], cell_w_max);
-		}
-		for (int i = start.y; i < end.y; ++i) {
-			row_min_sizes[i] = std::max(row_min_sizes[i], cell_h_min);
-			row_max_sizes[i] = std::max(row_max_sizes[i], cell_h_max);
-		}
+		col_mins.raise(start.x, end.x, cell_w_min);
+		col_maxs.raise(start.x, end.x, cell_w_max);
+		row_mins.raise(start.y, end.y, cell_h_min);
+		row_maxs.raise(start.y, end.y, cell_h_max);
 	}
 
+	col_mins.apply(col_min_sizes);
+	col_maxs.apply(col_max_sizes);
+	row_mins.apply(row_min_sizes);
+	row_maxs.apply(row_max_sizes);
+
 	Point min_size(
 		calc_length_with_gaps(col_min_sizes, col_gap),
 		calc_length_with_gaps(row_min_sizes, row_gap)
@@ -506,27 +796,15 @@ Point Grid::calc_layout_info()
 
 void Grid::alloc_row_col_data()
 {
-	row_sizes.resize(row_count);
-	ranges::fill(row_sizes, 0);
+	// Size limits are raised from zero, sizes and offsets are calculated
+	// from scratch by layout.
+	row_min_sizes.assign(row_count, 0);
+	row_max_sizes.assign(row_count, 0);
+	col_min_sizes.assign(col_count, 0);
+	col_max_sizes.assign(col_count, 0);
 
+	row_sizes.resize(row_count);
 	col_sizes.resize(col_count);
-	ranges::fill(col_sizes, 0);
-
-	row_max_sizes.resize(row_count);
-	ranges::fill(row_min_sizes, 0);
-
-	col_max_sizes.resize(col_count);
-	ranges::fill(col_min_sizes, 0);
-
-	row_min_sizes.resize(row_count);
-	ranges::fill(row_max_sizes, 0);
-
-	col_min_sizes.resize(col_count);
-	ranges::fill(col_max_sizes, 0);
-
 	row_offsets.resize(row_count);
-	ranges::fill(row_offsets, 0);
-
 	col_offsets.resize(col_count);
-	ranges::fill(col_offsets, 0);
-}
\ No newline at end of file
+}
@@ -0,0 +1,220 @@
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "widget.hxx"
+#include "scrollable.hxx"
+#include "file_view.hxx"
+#include "theme.hxx"
+#include "graphics.hxx"
+#include "managers.hxx"
+#include "utils/mapped_file.hxx"
+
+using namespace eggui;
+
+/// Bytes scanned by the thread before handing over the lines it found.
+constexpr std::size_t SCAN_BLOCK = 4 << 20;
+/// Longest part of a line drawn, the rest would not fit anyway.
+constexpr std::size_t MAX_LINE_BYTES = 4096;
+
+/// @brief Find line breaks in the range and add offsets after them.
+static void find_line_starts(
+	const char *data, std::size_t start, std::size_t end,
+	std::vector<std::uint64_t> &out
+)
+{
+	auto i = start;
+
+#if defined(__AVX2__)
+	const auto newline = _mm256_set1_epi8('\n');
+	for (; i + 32 <= end; i += 32) {
+		auto chunk = _mm256_loadu_si256(
+			reinterpret_cast<const __m256i *>(data + i)
+		);
+		unsigned mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, newline));
+		for (; mask; mask &= mask - 1)
+			out.push_back(i + std::countr_zero(mask) + 1);
+	}
+#elif defined(__SSE2__)
+	const auto newline = _mm_set1_epi8('\n');
+	for (; i + 16 <= end; i += 16) {
+		auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+		unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline));
+		for (; mask; mask &= mask - 1)
+			out.push_back(i + std::countr_zero(mask) + 1);
+	}
+#endif
+
+	for (; i < end; ++i) {
+		if (data[i] == '\n')
+			out.push_back(i + 1);
+	}
+}
+
+// FileView members
+//---------------------------------------------------------
+struct FileView::Index {
+	~Index()
+	{
+		stop = true;
+		if (thread.joinable())
+			thread.join();
+	}
+
+	/// @brief Find all the lines, handing them over a block at a time.
+	void find_lines()
+	{
+		file.advise_sequential();
+
+		std::vector<std::uint64_t> block;
+		for (std::size_t at = 0; at < file.size() && !stop; at += SCAN_BLOCK) {
+			block.clear();
+			auto end = std::min(file.size(), at + SCAN_BLOCK);
+			find_line_starts(file.data(), at, end, block);
+
+			std::lock_guard lock(mutex);
+			found.insert(found.end(), block.begin(), block.end());
+		}
+
+		std::lock_guard lock(mutex);
+		is_done = true;
+	}
+
+	MappedFile file;
+	std::thread thread;
+	std::atomic<bool> stop = false;
+
+	// Guards everything below, which is handed over to the UI thread.
+	std::mutex mutex;
+	// Line starts found and not yet taken.
+	std::vector<std::uint64_t> found;
+	bool is_done = false;
+};
+
+FileView::FileView(int w, int h, FontSize font_size_)
+	: Widget(w, h)
+	, line_starts{0}
+	, min_height(h)
+	, font_size(font_size_)
+{
+}
+
+FileView::~FileView() { TickManager::instance().remove(this); }
+
+bool FileView::open(const std::string &path)
+{
+	close();
+
+	auto idx = std::make_unique<Index>();
+	if (!idx->file.open(path))
+		return false;
+
+	index = std::move(idx);
+	is_index_complete = false;
+	index->thread = std::thread(&Index::find_lines, index.get());
+	TickManager::instance().add(this, [this]() { return take_lines(); });
+
+	fit_lines();
+	mark_damaged();
+	return true;
+}
+
+void FileView::close()
+{
+	TickManager::instance().remove(this);
+	index.reset();
+
+	line_starts = {0};
+	is_index_complete = true;
+	fit_lines();
+	mark_damaged();
+}
+
+bool FileView::is_indexing() const { return !is_index_complete; }
+
+long FileView::get_line_count() const
+{
+	// The last line is only known to be complete once all are found, and
+	// there is no line after a line break at the end.
+	long count = line_starts.size() - 1;
+	if (is_index_complete && index && line_starts.back() < index->file.size())
+		count++;
+
+	return count;
+}
+
+bool FileView::take_lines()
+{
+	{
+		std::lock_guard lock(index->mutex);
+		auto &found = index->found;
+		if (found.empty() && !index->is_done)
+			return true;
+
+		line_starts.insert(line_starts.end(), found.begin(), found.end());
+		found.clear();
+		is_index_complete = index->is_done;
+	}
+
+	fit_lines();
+	mark_damaged();
+	return !is_index_complete;
+}
+
+void FileView::fit_lines()
+{
+	int lh = get_line_height();
+	set_fixed_height(std::max(
+		min_height, VScrollView::calc_rows_height(get_line_count(), lh)
+	));
+}
+
+void FileView::draw()
+{
+	long count = get_line_count();
+	if (count == 0)
+		return;
+
+	// Lines are placed by how far the view is scrolled, rather than by their
+	// position in it, since a view of a huge file is shorter than its lines.
+	auto [top, view_len] = VScrollView::calc_shown_span(*this);
+	int lh = get_line_height();
+	double first = VScrollView::calc_first_row(
+		top, view_len, get_size().y, count, lh
+	);
+
+	auto [clip_pos, clip_size] = get_unclipped_region();
+	auto data = index->file.data();
+	std::string str;
+
+	long line = std::floor(first);
+	double ypos = top - (first - line) * lh;
+	for (; line < count && ypos < top + view_len; ++line, ypos += lh) {
+		if (ypos + lh <= clip_pos.y || ypos >= clip_pos.y + clip_size.y)
+			continue;
+
+		std::size_t start = line_starts[line];
+		std::size_t end = line + 1 < long(line_starts.size())
+							  ? line_starts[line + 1] - 1
+							  : index->file.size();
+		if (end > start && data[end - 1] == '\r')
+			end--;
+
+		str.assign(data + start, std::min(end - start, MAX_LINE_BYTES));
+		draw_text(Point(0, ypos), TEXT_COLOR, str.c_str(), font_size);
+	}
+}
@@ -1,200 +1,437 @@
 #include <cassert>
+#include <cmath>
+#include <cstring>
 #include <algorithm>
+#include <string>
+#include <tuple>
 #include <vector>
 #include <ranges>
 #include <utility>
 
-#define GRAPHICS_API_OPENGL_33
-
-#include "raylib/raylib.h"
-#include "raylib/rlgl.h"
-
-#include "roboto_mono.bin.h"
 #include "graphics.hxx"
+#include "backend.hxx"
 #include "point.hxx"
 #include "theme.hxx"
 #include "canvas.hxx"
+#include "managers.hxx"
 
 using namespace eggui;
 
-/// Font glyphs need to be rendered for each font size, indexed by FontSize.
-/// Since we load only a fixed number of fonts, we dont really need manager for it.
-static Font g_mono_fonts[FONT_SIZE_COUNT];
+/// Backend doing the actual drawing, created on first use if none is set.
+static std::unique_ptr<Backend> g_backend;
 
-// Conversion and functions
-//---------------------------------------------------------
-constexpr inline Color to_color(RGBA rgba)
+inline int get_index_for_font_size(eggui::FontSize font_size)
 {
-	return Color{rgba.r, rgba.g, rgba.b, rgba.a};
+	return static_cast<int>(font_size);
 }
 
-constexpr inline Vector2 to_vec2(Point point)
+// Offscreen render targets
+//---------------------------------------------------------
+/// Sizes of render targets indexed by id - 1, freed targets have zero size.
+/// Ids are the same as those given by the backend.
+static std::vector<Point> g_targets;
+/// Render targets being drawn onto, the innermost one is the last.
+static std::vector<int> g_active_targets;
+static std::size_t g_target_budget = DEFAULT_RENDER_TARGET_BUDGET;
+static std::size_t g_target_usage = 0;
+
+inline bool is_valid_target(int id)
 {
-	return Vector2{static_cast<float>(point.x), static_cast<float>(point.y)};
+	return id > 0 && id <= int(g_targets.size())
+		   && g_targets[id - 1] != Point(0, 0);
 }
 
-inline Rectangle points_to_rect(Point pos, Point size)
+/// @brief Calculate memory used by a render target of the size.
+/// It has color and depth buffers, each taking 4 bytes per pixel.
+inline std::size_t calc_target_bytes(Point size)
 {
-	Rectangle ret;
-	ret.x = pos.x;
-	ret.y = pos.y;
-	ret.width = size.x;
-	ret.height = size.y;
+	return 8 * static_cast<std::size_t>(size.x) * size.y;
+}
 
-	return ret;
+// Draw call execution
+//---------------------------------------------------------
+/// Draw lists being recorded into, only the last one is recorded into.
+/// A null entry suspends recording, like while drawing a sub-draw.
+static std::vector<DrawList *> g_recordings;
+
+/// @brief Actually draw using the backend.
+static void execute_command(const DrawCommand &cmd, const char *text)
+{
+	switch (cmd.op) {
+	case DrawOp::Subdraw:
+		// Sub-draws record their own draw calls(if any), not into ours.
+		g_recordings.push_back(nullptr);
+		cmd.subdraw(cmd.subdraw_arg);
+		g_recordings.pop_back();
+		break;
+	case DrawOp::RenderTarget:
+		if (is_valid_target(cmd.target))
+			get_backend().draw(cmd, text);
+		break;
+	default:
+		get_backend().draw(cmd, text);
+		break;
+	}
 }
 
-// Calculation & transformation functions
+// Draw call batching
 //---------------------------------------------------------
-inline Rectangle shrink_from_center(Rectangle rect, float x, float y)
+/// Number of most recent batches searched for a batch to join.
+constexpr int BATCH_LOOKBACK = 32;
+
+/// Draw calls which can be drawn one after another without changing any
+/// graphics state, they are drawn by the graphics library in a single go.
+struct Batch {
+	// Clip area on screen.
+	Point clip_pos;
+	Point clip_size;
+	// Graphics state(texture and primitive type) needed by the draw calls.
+	int state;
+	// Bounding box of everything drawn by the batch on screen.
+	Point bounds_pos;
+	Point bounds_size;
+	// First and last draw calls of the batch, draw calls are linked.
+	int first;
+	int last;
+};
+
+struct BatchedCommand {
+	DrawCommand cmd;
+	// Next draw call in the same batch, -1 if none.
+	int next;
+};
+
+static bool g_is_batching = false;
+static std::vector<Batch> g_batches;
+static std::vector<BatchedCommand> g_batched_commands;
+// Null terminated texts of the batched text draw calls, stored back to back.
+static std::string g_batched_texts;
+
+/// @brief Get the graphics state needed for drawing the draw call, draw calls
+///        with different states cannot be drawn together.
+inline int get_draw_state(const DrawCommand &cmd)
 {
-	rect.x += x;
-	rect.y += y;
-	rect.height -= 2 * x;
-	rect.width -= 2 * y;
-	return rect;
+	switch (cmd.op) {
+	case DrawOp::Line:
+	case DrawOp::RectLines:
+		return 1;
+	case DrawOp::Text:
+		return 2 + get_index_for_font_size(cmd.font_size);
+	case DrawOp::RenderTarget:
+		return 2 + FONT_SIZE_COUNT + cmd.target;
+	default:
+		return 0;
+	}
 }
 
-inline int calc_segments(float radius, float angle = 360.0)
+/// @brief Translate the position of everything the draw call will draw.
+inline void translate_command(DrawCommand &cmd, Point offset)
 {
-	angle = std::abs(angle);
-	// Too many segments value causes artifacts at corners when AA4X is enabled.
-	if (radius < 5.)
-		return 10. * angle / 360;
-	return radius * 1.5 * angle / 360;
+	switch (cmd.op) {
+	case DrawOp::Line:
+		cmd.points[1] += offset;
+		break;
+	case DrawOp::Triangle:
+		cmd.points[1] += offset;
+		cmd.points[2] += offset;
+		break;
+	default:
+		break;
+	}
+
+	cmd.points[0] += offset;
 }
 
-inline int get_index_for_font_size(eggui::FontSize font_size)
+/// @brief Calculates bounding box of everything the draw call will draw.
+/// @return Rectangle: position and size.
+inline std::pair<Point, Point>
+calc_command_bounds(const DrawCommand &cmd, const char *text)
 {
-	return static_cast<int>(font_size);
+	Point p0 = cmd.points[0];
+	Point p1 = cmd.points[1];
+	Point p2 = cmd.points[2];
+	auto radius_box = [p0](float radius) {
+		int r = std::ceil(radius);
+		return std::pair(p0 - Point(r, r), Point(2 * r + 1, 2 * r + 1));
+	};
+
+	switch (cmd.op) {
+	case DrawOp::Rect:
+	case DrawOp::RectLines:
+	case DrawOp::RoundedRect:
+	case DrawOp::RenderTarget:
+		return {p0, p1};
+	case DrawOp::Circle:
+	case DrawOp::CircleSector:
+		return radius_box(cmd.params[0]);
+	case DrawOp::Ring:
+		return radius_box(cmd.params[1]);
+	case DrawOp::Text: {
+		// Glyphs of the monospace font we use are narrower than their height.
+		int px = FONT_PX_SIZES[get_index_for_font_size(cmd.font_size)];
+		int len = std::strlen(text);
+		Point size(len * (px + cmd.params[0]), px);
+		// The backend lays out the lines after the first, and measures them.
+		if (std::strchr(text, '\n'))
+			size.y = std::max(px, tell_text_size(text, cmd.font_size).y);
+		return {p0, size};
+	}
+	default:
+		break;
+	}
+
+	// Lines and triangles, unused points are the same as the first one.
+	if (cmd.op == DrawOp::Pixel || cmd.op == DrawOp::Line)
+		p2 = p0;
+	if (cmd.op == DrawOp::Pixel)
+		p1 = p0;
+
+	auto lo = min_components(min_components(p0, p1), p2);
+	auto hi = max_components(max_components(p0, p1), p2);
+	return {lo, hi - lo + Point(1, 1)};
+}
+
+/// @brief Add the draw call to a batch, it is added to the most recent
+///        compatible batch if it does not overlap anything drawn after it.
+static void batch_command(DrawCommand cmd, const char *text)
+{
+	translate_command(cmd, get_total_translation());
+
+	auto &clipper = ClippingManager::instance();
+	auto [clip_pos, clip_size] = clipper.get_current_clip_region();
+	auto [pos, size] = calc_command_bounds(cmd, text);
+
+	// Nothing to draw if it lies outside of the clip area.
+	if (!check_box_collision(pos, size, clip_pos, clip_size))
+		return;
+
+	// Every clip area lies inside of the outermost one, so if nothing gets
+	// clipped then clipping to the outermost area gives the same result.
+	// This lets draw calls of different widgets share a batch.
+	if (is_box_inside_box(clip_pos, clip_size, pos, size))
+		std::tie(clip_pos, clip_size) = clipper.get_outermost_clip_region();
+
+	if (cmd.op == DrawOp::Text) {
+		cmd.text_at = g_batched_texts.size();
+		g_batched_texts.append(text);
+		g_batched_texts.push_back('\0');
+	}
+
+	int index = g_batched_commands.size();
+	g_batched_commands.push_back(BatchedCommand{.cmd = cmd, .next = -1});
+
+	const int state = get_draw_state(cmd);
+	const int stop = std::max(0, int(g_batches.size()) - BATCH_LOOKBACK);
+
+	for (int i = int(g_batches.size()) - 1; i >= stop; --i) {
+		auto &b = g_batches[i];
+
+		if (b.state == state && b.clip_pos == clip_pos
+			&& b.clip_size == clip_size) {
+			g_batched_commands[b.last].next = index;
+			b.last = index;
+
+			auto lo = min_components(b.bounds_pos, pos);
+			auto hi = max_components(b.bounds_pos + b.bounds_size, pos + size);
+			b.bounds_pos = lo;
+			b.bounds_size = hi - lo;
+			return;
+		}
+
+		// Cannot be drawn before something it overlaps.
+		if (check_box_collision(b.bounds_pos, b.bounds_size, pos, size))
+			break;
+	}
+
+	g_batches.push_back(Batch{
+		.clip_pos = clip_pos,
+		.clip_size = clip_size,
+		.state = state,
+		.bounds_pos = pos,
+		.bounds_size = size,
+		.first = index,
+		.last = index,
+	});
+}
+
+/// @brief Draw all the batches, changing clip area only when needed.
+static void flush_batches()
+{
+	auto &clipper = ClippingManager::instance();
+
+	for (auto &b : g_batches) {
+		clipper.commit_area(b.clip_pos, b.clip_size);
+
+		for (int i = b.first; i != -1; i = g_batched_commands[i].next) {
+			auto &cmd = g_batched_commands[i].cmd;
+			auto text = cmd.op == DrawOp::Text
+							? g_batched_texts.c_str() + cmd.text_at
+							: nullptr;
+			execute_command(cmd, text);
+		}
+	}
+
+	clipper.reset();
+
+	g_batches.clear();
+	g_batched_commands.clear();
+	g_batched_texts.clear();
+}
+
+/// @brief Record the draw call if recording and then draw or batch it.
+/// Draw calls are translated here, the graphics library draws without any
+/// translation of its own.
+static void submit_command(const DrawCommand &cmd, const char *text = nullptr)
+{
+	if (!g_recordings.empty() && g_recordings.back())
+		g_recordings.back()->add(cmd, text);
+
+	// Sub-draws are never batched, only the draw calls they make.
+	if (cmd.op == DrawOp::Subdraw) {
+		execute_command(cmd, text);
+	} else if (g_is_batching) {
+		batch_command(cmd, text);
+	} else {
+		auto translated = cmd;
+		translate_command(translated, get_total_translation());
+
+		ClippingManager::instance().commit();
+		execute_command(translated, text);
+	}
 }
 
 namespace eggui
 {
 
+void set_backend(std::unique_ptr<Backend> backend)
+{
+	assert(!g_backend || !g_backend->is_window_open());
+	g_backend = std::move(backend);
+	TextMetricsManager::instance().clear();
+}
+
+Backend &get_backend()
+{
+	if (!g_backend)
+		g_backend = make_raylib_backend();
+
+	return *g_backend;
+}
+
 void init_graphics()
 {
-	for (int i = 0; i < FONT_SIZE_COUNT; ++i) {
-		g_mono_fonts[i] = LoadFontFromMemory(
-			".ttf", ROBOTO_MONO_TTF, ROBOTO_MONO_TTF_LEN, FONT_PX_SIZES[i],
-			nullptr, 0
-		);
-	}
+	get_backend().load_fonts();
+	// Fonts may differ from those used for measuring earlier.
+	TextMetricsManager::instance().clear();
 }
 
 void deinit_graphics()
 {
-	for (auto &font : g_mono_fonts)
-		UnloadFont(font);
+	get_backend().unload_fonts();
+
+	for (int id = 1; id <= int(g_targets.size()); ++id) {
+		if (is_valid_target(id))
+			destroy_render_target(id);
+	}
 }
 
 void push_translation(Point pt)
 {
-	rlPushMatrix();
-	rlTranslatef(pt.x, pt.y, 0);
+	TranslationManager::instance().push_translation(pt);
 }
 
-void pop_translation() { rlPopMatrix(); }
+void pop_translation() { TranslationManager::instance().pop_translation(); }
 
 Point get_total_translation()
 {
-	auto tmat = rlGetMatrixTransform();
-	return Point(tmat.m12, tmat.m13);
+	return TranslationManager::instance().get_total_translation();
 }
 
-Point get_window_size() { return Point(GetScreenWidth(), GetScreenHeight()); }
+Point get_window_size() { return get_backend().get_window_size(); }
 
 void set_cursor_shape(CursorShape shape)
 {
-	using enum CursorShape;
-	switch (shape) {
-	case Default:
-		SetMouseCursor(MOUSE_CURSOR_DEFAULT);
-		break;
-	case Arrow:
-		SetMouseCursor(MOUSE_CURSOR_ARROW);
-		break;
-	case IBeam:
-		SetMouseCursor(MOUSE_CURSOR_IBEAM);
-		break;
-	case Cross:
-		SetMouseCursor(MOUSE_CURSOR_CROSSHAIR);
-		break;
-	case Hand:
-		SetMouseCursor(MOUSE_CURSOR_POINTING_HAND);
-		break;
-	case ResizeEW:
-		SetMouseCursor(MOUSE_CURSOR_RESIZE_EW);
-		break;
-	case ResizeNS:
-		SetMouseCursor(MOUSE_CURSOR_RESIZE_NS);
-		break;
-	case ResizeNWSE:
-		SetMouseCursor(MOUSE_CURSOR_RESIZE_NWSE);
-		break;
-	case ResizeNESW:
-		SetMouseCursor(MOUSE_CURSOR_RESIZE_NESW);
-		break;
-	case ResizeOmni:
-		SetMouseCursor(MOUSE_CURSOR_RESIZE_ALL);
-		break;
-	case Disallowed:
-		SetMouseCursor(MOUSE_CURSOR_NOT_ALLOWED);
-		break;
-	}
+	get_backend().set_cursor_shape(shape);
 }
 
-void clear_background() { ClearBackground(to_color(BACKGROUND_COLOR)); }
+void clear_background() { get_backend().clear(BACKGROUND_COLOR); }
 
-void draw_pixel(Point v, RGBA color) { DrawPixel(v.x, v.y, to_color(color)); }
+void draw_pixel(Point v, RGBA color)
+{
+	DrawCommand cmd{.op = DrawOp::Pixel, .color = color};
+	cmd.points[0] = v;
+	submit_command(cmd);
+}
 
 void draw_line(Point start, Point end, RGBA color)
 {
-	DrawLine(start.x, start.y, end.x, end.y, to_color(color));
+	DrawCommand cmd{.op = DrawOp::Line, .color = color};
+	cmd.points[0] = start;
+	cmd.points[1] = end;
+	submit_command(cmd);
 }
 
 void draw_rect(Point position, Point size, RGBA color)
 {
-	DrawRectangle(position.x, position.y, size.x, size.y, to_color(color));
+	DrawCommand cmd{.op = DrawOp::Rect, .color = color};
+	cmd.points[0] = position;
+	cmd.points[1] = size;
+	submit_command(cmd);
 }
 
 void draw_rect_lines(Point position, Point size, RGBA color)
 {
-	DrawRectangleLines(position.x, position.y, size.x, size.y, to_color(color));
+	DrawCommand cmd{.op = DrawOp::RectLines, .color = color};
+	cmd.points[0] = position;
+	cmd.points[1] = size;
+	submit_command(cmd);
 }
 
 void draw_rounded_rect(Point position, Point size, float round, RGBA color)
 {
-	auto rect = points_to_rect(position, size);
-	auto segs = calc_segments(std::min(position.x, position.y) / 2. * round);
-	DrawRectangleRounded(rect, round, segs, to_color(color));
+	DrawCommand cmd{.op = DrawOp::RoundedRect, .color = color};
+	cmd.points[0] = position;
+	cmd.points[1] = size;
+	cmd.params[0] = round;
+	submit_command(cmd);
 }
 
 void draw_cirlce(Point center, float radius, RGBA color)
 {
-	DrawCircle(center.x, center.y, radius, to_color(color));
+	DrawCommand cmd{.op = DrawOp::Circle, .color = color};
+	cmd.points[0] = center;
+	cmd.params[0] = radius;
+	submit_command(cmd);
 }
 
 void draw_cirlce_sector(
 	Point position, float radius, float start_angle, float end_angle, RGBA color
 )
 {
-	int segs = calc_segments(radius, end_angle - start_angle);
-	DrawCircleSector(
-		to_vec2(position), radius, start_angle, end_angle, segs, to_color(color)
-	);
+	DrawCommand cmd{.op = DrawOp::CircleSector, .color = color};
+	cmd.points[0] = position;
+	cmd.params[0] = radius;
+	cmd.params[1] = start_angle;
+	cmd.params[2] = end_angle;
+	submit_command(cmd);
 }
+
 void draw_ring(Point center, float inner_rad, float outer_rad, RGBA color)
 {
-	DrawRing(
-		to_vec2(center), inner_rad, outer_rad, 0, 360.,
-		calc_segments(outer_rad), to_color(color)
-	);
+	DrawCommand cmd{.op = DrawOp::Ring, .color = color};
+	cmd.points[0] = center;
+	cmd.params[0] = inner_rad;
+	cmd.params[1] = outer_rad;
+	submit_command(cmd);
 }
 
 void draw_triangle(Point v1, Point v2, Point v3, RGBA color)
 {
-	DrawTriangle(to_vec2(v1), to_vec2(v2), to_vec2(v3), to_color(color));
+	DrawCommand cmd{.op = DrawOp::Triangle, .color = color};
+	cmd.points[0] = v1;
+	cmd.points[1] = v2;
+	cmd.points[2] = v3;
+	submit_command(cmd);
 }
 
 void draw_text(
@@ -202,17 +439,178 @@ void draw_text(
 	int spacing
 )
 {
-	int idx = get_index_for_font_size(font_size);
-	DrawTextEx(
-		g_mono_fonts[idx], text, to_vec2(position), FONT_PX_SIZES[idx], spacing,
-		to_color(color)
-	);
+	DrawCommand cmd{.op = DrawOp::Text, .font_size = font_size, .color = color};
+	cmd.points[0] = position;
+	cmd.params[0] = spacing;
+	submit_command(cmd, text);
 }
 
 Point tell_text_size(const char *text, FontSize font_size)
 {
-	int idx = get_index_for_font_size(font_size);
-	auto sz = MeasureTextEx(g_mono_fonts[idx], text, FONT_PX_SIZES[idx], 0);
-	return Point(sz.x, sz.y);
+	return TextMetricsManager::instance().measure_text(text, font_size);
+}
+
+float tell_glyph_advance(int codepoint, FontSize font_size)
+{
+	return TextMetricsManager::instance().get_glyph_advance(codepoint, font_size);
+}
+
+TextCacheStats get_text_cache_stats()
+{
+	return TextMetricsManager::instance().get_stats();
+}
+
+void reset_text_cache_stats() { TextMetricsManager::instance().reset_stats(); }
+
+ClipStats get_clip_stats() { return ClippingManager::instance().get_stats(); }
+
+void reset_clip_stats() { ClippingManager::instance().reset_stats(); }
+
+// Offscreen drawing
+//---------------------------------------------------------
+int create_render_target(Point size)
+{
+	if (size.x <= 0 || size.y <= 0)
+		return 0;
+
+	auto bytes = calc_target_bytes(size);
+	if (g_target_usage + bytes > g_target_budget)
+		return 0;
+
+	int id = get_backend().create_target(size);
+	if (id == 0)
+		return 0;
+
+	assert(!is_valid_target(id));
+	if (id > int(g_targets.size()))
+		g_targets.resize(id, Point(0, 0));
+
+	g_targets[id - 1] = size;
+	g_target_usage += bytes;
+	return id;
+}
+
+void destroy_render_target(int id)
+{
+	// All the targets are freed by deinit_graphics.
+	if (!is_valid_target(id))
+		return;
+
+	g_target_usage -= calc_target_bytes(g_targets[id - 1]);
+	g_targets[id - 1] = Point(0, 0);
+	get_backend().destroy_target(id);
+}
+
+void begin_render_target(int id)
+{
+	assert(is_valid_target(id));
+
+	// Whatever has been batched till now is drawn onto the earlier target.
+	flush_batches();
+
+	ClippingManager::instance().save_clip_areas();
+	TranslationManager::instance().save_translations();
+	g_active_targets.push_back(id);
+
+	auto &backend = get_backend();
+	backend.set_target(id);
+	backend.clear(BACKGROUND_COLOR);
+
+	ClippingManager::instance().push_clip_area(Point(0, 0), g_targets[id - 1]);
+}
+
+void end_render_target()
+{
+	assert(!g_active_targets.empty());
+
+	ClippingManager::instance().pop_clip_area();
+	flush_batches();
+
+	// Resume drawing onto the outer target, or the window if none.
+	g_active_targets.pop_back();
+	get_backend().set_target(
+		g_active_targets.empty() ? 0 : g_active_targets.back()
+	);
+
+	ClippingManager::instance().restore_clip_areas();
+	TranslationManager::instance().restore_translations();
+}
+
+void draw_render_target(Point position, int id)
+{
+	assert(is_valid_target(id));
+
+	DrawCommand cmd{.op = DrawOp::RenderTarget, .color = RGBA(255, 255, 255)};
+	cmd.points[0] = position;
+	cmd.points[1] = g_targets[id - 1];
+	cmd.target = id;
+	submit_command(cmd);
+}
+
+void set_render_target_budget(std::size_t bytes) { g_target_budget = bytes; }
+
+std::size_t get_render_target_usage() { return g_target_usage; }
+
+// Retained drawing
+//---------------------------------------------------------
+void DrawList::clear()
+{
+	commands.clear();
+	texts.clear();
+}
+
+void DrawList::add(DrawCommand cmd, const char *text)
+{
+	if (cmd.op == DrawOp::Text) {
+		cmd.text_at = texts.size();
+		texts.append(text);
+		texts.push_back('\0');
+	}
+
+	commands.push_back(cmd);
+}
+
+void DrawList::replay() const
+{
+	for (auto &cmd : commands) {
+		auto text = cmd.op == DrawOp::Text ? texts.c_str() + cmd.text_at
+										   : nullptr;
+		submit_command(cmd, text);
+	}
+}
+
+void begin_recording(DrawList &list) { g_recordings.push_back(&list); }
+
+void end_recording()
+{
+	assert(!g_recordings.empty() && g_recordings.back());
+	g_recordings.pop_back();
+}
+
+bool is_recording() { return !g_recordings.empty() && g_recordings.back(); }
+
+void begin_batching()
+{
+	assert(!g_is_batching);
+	g_is_batching = true;
+}
+
+void end_batching()
+{
+	assert(g_is_batching);
+
+	// Draw calls are batched in absolute positions.
+	assert(get_total_translation() == Point(0, 0));
+	flush_batches();
+
+	g_is_batching = false;
+}
+
+void draw_subdraw(void (*draw_fn)(void *), void *arg)
+{
+	DrawCommand cmd{.op = DrawOp::Subdraw};
+	cmd.subdraw = draw_fn;
+	cmd.subdraw_arg = arg;
+	submit_command(cmd);
 }
 } // namespace eggui
@@ -5,8 +5,6 @@
 #include "input.hxx"
 #include "theme.hxx"
 
-#include "raylib/raylib.h"
-
 using namespace eggui;
 
 // TODO Implement auto height calculation
@@ -27,10 +25,12 @@ Widget *TextInput::notify(Event ev)
 {
 	auto blink = [this](int, float progress) {
 		// Use 1 - (2x - 1)^2 for the blink animation of the cursor.
+		// Only the cursor is damaged, not the whole widget, so that just the
+		// cursor gets redrawn.
 		double opacity = 1 - std::pow(2. * progress - 1, 2);
 		text.set_cursor_opacity(opacity);
 
-		return true;
+		return false;
 	};
 
 	// TODO Handle more possible keypresses and text select.
@@ -63,13 +63,13 @@ Widget *TextInput::notify(Event ev)
 		return this;
 
 	case EventType::KeyPressed:
-		if (ev.keycode == KEY_DELETE)
+		if (ev.keycode == int(Key::Delete))
 			text.delete_after_cursor();
-		else if (ev.keycode == KEY_BACKSPACE)
+		else if (ev.keycode == int(Key::Backspace))
 			text.delete_before_cursor();
-		else if (ev.keycode == KEY_LEFT)
+		else if (ev.keycode == int(Key::Left))
 			text.move_cursor(-1);
-		else if (ev.keycode == KEY_RIGHT)
+		else if (ev.keycode == int(Key::Right))
 			text.move_cursor(1);
 
 		return this;
@@ -8,7 +8,11 @@
 
 using namespace eggui;
 
-void Label::set_text(std::string txt) { text = std::move(txt); }
+void Label::set_text(std::string txt)
+{
+	text = std::move(txt);
+	mark_damaged();
+}
 
 void Label::draw()
 {
@@ -0,0 +1,217 @@
+#include <cassert>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+
+#include "widget.hxx"
+#include "container.hxx"
+#include "scrollable.hxx"
+#include "list_view.hxx"
+#include "graphics.hxx"
+#include "calc.hxx"
+
+using namespace eggui;
+
+ListView::ListView(int w, int row_height_, ListSource source_)
+	: Container(w, 0)
+	, source(std::move(source_))
+	, row_height(row_height_)
+{
+	assert(row_height > 0);
+	assert(source.get_count && source.make_row && source.bind_row);
+
+	item_count = std::max(0, source.get_count());
+}
+
+void ListView::set_overscan(int rows_)
+{
+	overscan = std::max(0, rows_);
+	update_rows();
+}
+
+void ListView::refresh()
+{
+	item_count = std::max(0, source.get_count());
+	for (auto &row : rows)
+		row.index = -1;
+
+	// Resize right away, so that new items can be scrolled to before the
+	// next update.
+	invalidate_layout();
+	update_layout_info();
+	set_size(Point(get_size().x, get_min_size().y));
+	mark_damaged();
+}
+
+void ListView::scroll_to_item(int index)
+{
+	assert(0 <= index && index < item_count);
+
+	auto view = dynamic_cast<VScrollView *>(get_parent());
+	if (!view)
+		return;
+
+	// Scroll as little as needed, bringing the item to the top or the bottom.
+	auto [top, view_len] = VScrollView::calc_shown_span(*this);
+	int height = get_size().y;
+	double first = VScrollView::calc_first_row(
+		top, view_len, height, item_count, row_height
+	);
+	double shown = double(view_len) / row_height;
+	double to_top = VScrollView::calc_row_top(
+		index, view_len, height, item_count, row_height
+	);
+	double to_bottom = VScrollView::calc_row_top(
+		index + 1 - shown, view_len, height, item_count, row_height
+	);
+
+	// A pixel scrolled may pass several rows of a huge list, so round towards
+	// showing the whole item, though not for mere rounding errors.
+	constexpr double SLACK = 1e-6;
+	if (index < first)
+		view->scroll_into_view(std::floor(to_top + SLACK), view_len);
+	else if (index + 1 > first + shown)
+		view->scroll_into_view(std::ceil(to_bottom - SLACK), view_len);
+}
+
+void ListView::set_position(Point new_pos)
+{
+	Widget::set_position(new_pos);
+	update_rows();
+}
+
+void ListView::layout_children(Point size_hint)
+{
+	size_hint = clamp_components(size_hint, get_min_size(), get_max_size());
+	Widget::set_size(size_hint);
+
+	for (auto &row : rows)
+		fit_row(*row.widget);
+	update_rows();
+}
+
+Point ListView::calc_layout_info()
+{
+	for (auto &row : rows)
+		calc_layout_info_if_container(*row.widget);
+
+	// The width given is kept as minimum, the list stretches beyond it.
+	int height = VScrollView::calc_rows_height(item_count, row_height);
+	set_min_size(Point(get_min_size().x, height));
+	set_max_size(Point(UNLIMITED_MAX_SIZE, height));
+	return get_min_size();
+}
+
+Widget *ListView::notify(Event ev)
+{
+	if (ev.cursor.y < first_ypos)
+		return nullptr;
+
+	// Rows are all the same height, so the row under the cursor is known
+	// without looking through them.
+	int index = find_item_at(ev.cursor.y);
+	if (index < first_shown || index >= last_shown)
+		return nullptr;
+
+	auto &row = row_for(index);
+	if (row.widget->collides_with_point(ev.cursor))
+		return notify_widget(*row.widget, ev);
+	return nullptr;
+}
+
+void ListView::draw()
+{
+	int first = first_shown;
+	int last = last_shown;
+
+	// While recording the whole list is drawn, since the recording may be
+	// replayed with another clip area.
+	if (!is_recording()) {
+		auto [pos, size] = get_unclipped_region();
+		first = std::max(first, find_item_at(pos.y));
+		last = std::min(last, find_item_at(pos.y + size.y - 1) + 1);
+	}
+
+	for (int i = first; i < last; ++i)
+		draw_widget(*row_for(i).widget);
+}
+
+void ListView::draw_debug()
+{
+	Container::draw_debug();
+
+	for (int i = first_shown; i < last_shown; ++i)
+		draw_widget_debug(*row_for(i).widget);
+}
+
+std::pair<int, int> ListView::calc_shown_items(double place, int view_len) const
+{
+	int first = std::max(0, int(std::floor(place)) - overscan);
+	int last = std::ceil(place + double(view_len) / row_height) + overscan;
+	last = std::min(item_count, last);
+	return std::pair(first, std::max(first, last));
+}
+
+int ListView::find_item_at(int ypos) const
+{
+	// Floor the division, positions above the first row give items before it.
+	int offset = ypos - first_ypos;
+	int skipped = offset >= 0 ? offset / row_height
+							  : -((row_height - 1 - offset) / row_height);
+	return first_shown + skipped;
+}
+
+void ListView::update_rows()
+{
+	// Rows are placed by how far the list is scrolled, rather than at their
+	// position in it, since a huge list is shorter than its rows.
+	auto [top, view_len] = VScrollView::calc_shown_span(*this);
+	double place = VScrollView::calc_first_row(
+		top, view_len, get_size().y, item_count, row_height
+	);
+	auto [first, last] = calc_shown_items(place, view_len);
+	first_ypos = top + std::lround((first - place) * row_height);
+
+	int needed = last - first;
+	if (needed > int(rows.size())) {
+		while (int(rows.size()) < needed) {
+			auto widget = source.make_row();
+			widget->set_parent(this);
+			fit_row(*widget);
+			rows.push_back(Row{.widget = std::move(widget)});
+		}
+
+		// Items map to other rows once the ring grows.
+		for (auto &row : rows)
+			row.index = -1;
+	}
+
+	first_shown = first;
+	last_shown = last;
+
+	for (int i = first; i < last; ++i) {
+		auto &row = row_for(i);
+		Point pos(0, first_ypos + (i - first) * row_height);
+		if (row.index == i && row.widget->get_position() == pos)
+			continue;
+
+		row.widget->set_position(pos);
+		if (row.index != i) {
+			row.index = i;
+			source.bind_row(*row.widget, i);
+		}
+		row.widget->mark_damaged();
+	}
+}
+
+void ListView::fit_row(Widget &row)
+{
+	calc_layout_info_if_container(row);
+
+	auto size = calc_stretched_size(
+		row.get_min_size(), row.get_max_size(),
+		Point(get_size().x, row_height), Fill::RowNColumn
+	);
+	row.set_size(size);
+}
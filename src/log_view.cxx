@@ -0,0 +1,143 @@
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "widget.hxx"
+#include "scrollable.hxx"
+#include "log_view.hxx"
+#include "theme.hxx"
+#include "graphics.hxx"
+#include "managers.hxx"
+#include "backend.hxx"
+#include "utils/ring_queue.hxx"
+
+using namespace eggui;
+
+/// Longest part of a line kept, the rest would not fit anyway.
+constexpr std::size_t MAX_LINE_BYTES = 1024;
+
+// LogView members
+//---------------------------------------------------------
+struct LogView::Incoming {
+	explicit Incoming(std::size_t capacity)
+		: queue(capacity)
+	{
+	}
+
+	RingQueue<std::string> queue;
+	std::atomic<long> dropped = 0;
+	// Set once lines are appended, until the view takes them.
+	std::atomic<bool> pending = false;
+};
+
+LogView::LogView(int w, int h, std::size_t max_lines_, FontSize font_size_)
+	: Widget(w, h)
+	, incoming(std::make_unique<Incoming>(max_lines_))
+	, max_lines(max_lines_)
+	, min_height(h)
+	, font_size(font_size_)
+{
+	assert(max_lines > 0);
+
+	// Lines may be appended at any time, appending wakes us to take them.
+	TickManager::instance().add_waiting(this, incoming->pending, [this]() {
+		return take_lines();
+	});
+}
+
+LogView::~LogView() { TickManager::instance().remove(this); }
+
+bool LogView::append(std::string line)
+{
+	if (line.size() > MAX_LINE_BYTES)
+		line.resize(MAX_LINE_BYTES);
+
+	if (!incoming->queue.push(std::move(line))) {
+		incoming->dropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	// Only the first line appended since the view last took them wakes it.
+	if (!incoming->pending.exchange(true, std::memory_order_release))
+		get_backend().wake();
+	return true;
+}
+
+void LogView::clear()
+{
+	lines.clear();
+	fit_lines();
+	mark_damaged();
+}
+
+long LogView::get_dropped_count() const
+{
+	return incoming->dropped.load(std::memory_order_relaxed);
+}
+
+bool LogView::take_lines()
+{
+	// Cleared before taking, so lines appended meanwhile set it again.
+	incoming->pending.exchange(false, std::memory_order_acquire);
+
+	auto view = dynamic_cast<VScrollView *>(get_parent());
+	int top = view ? -get_position().y : 0;
+	bool at_end = !view || top + view->get_size().y >= get_size().y;
+
+	// Take at most a queue full, so that producers can not keep us here.
+	std::size_t taken = 0;
+	std::size_t removed = 0;
+	std::string line;
+	while (taken < incoming->queue.capacity() && incoming->queue.pop(line)) {
+		lines.push_back(std::move(line));
+		taken++;
+
+		if (lines.size() > max_lines) {
+			lines.pop_front();
+			removed++;
+		}
+	}
+
+	if (taken == 0)
+		return false;
+
+	// Lines are left in the queue only if a queue full was taken.
+	bool is_full = taken == incoming->queue.capacity();
+
+	fit_lines();
+	mark_damaged();
+	if (!view)
+		return is_full;
+
+	// Either keep showing the latest lines, or keep showing the same lines
+	// as older ones are removed from above them.
+	if (follow_tail && at_end)
+		view->scroll_into_view(get_size().y - 1, 1);
+	else if (removed > 0)
+		view->scroll_into_view(
+			std::max(0, top - int(removed) * get_line_height()), 0
+		);
+
+	return is_full;
+}
+
+void LogView::fit_lines()
+{
+	set_fixed_height(
+		std::max<int>(min_height, lines.size() * get_line_height())
+	);
+}
+
+void LogView::draw()
+{
+	// Only the lines in the visible part of the view are drawn.
+	int lh = get_line_height();
+	auto [first, last] = calc_visible_rows(lh, lines.size());
+
+	for (int i = first; i < last; ++i)
+		draw_text(Point(0, i * lh), TEXT_COLOR, lines[i].c_str(), font_size);
+}
@@ -2,11 +2,12 @@
 #include <algorithm>
 #include <utility>
 
-#include "raylib/raylib.h"
-
 #include "point.hxx"
 #include "managers.hxx"
 #include "graphics.hxx"
+#include "backend.hxx"
+#include "utils/swap_remove.hxx"
+#include "utils/utf8.hxx"
 
 using std::max;
 using std::min;
@@ -31,6 +32,19 @@ find_intersection(pair<Point, Point> rect1, pair<Point, Point> rect2)
 	return pair(c, c1 - c);
 }
 
+pair<Point, Point>
+find_bounding_box(pair<Point, Point> rect1, pair<Point, Point> rect2)
+{
+	auto a = rect1.first;
+	auto b = rect2.first;
+	auto a1 = a + rect1.second;
+	auto b1 = b + rect2.second;
+
+	auto c = min_components(a, b);
+	auto c1 = max_components(a1, b1);
+	return pair(c, c1 - c);
+}
+
 // Clipping manager members
 //---------------------------------------------------------
 ClippingManager &ClippingManager::instance()
@@ -43,15 +57,8 @@ void ClippingManager::push_clip_area(Point start, Point size)
 {
 	assert(is_enabled);
 
-	auto new_area = calc_clip_area(start, size);
-	auto [pos, sz] = new_area;
-
-	// Remove the previous area, we restore it when this new area is removed.
-	if (!clip_areas.empty())
-		EndScissorMode();
-
-	BeginScissorMode(pos.x, pos.y, sz.x, sz.y);
-	clip_areas.push_back(new_area);
+	clip_areas.push_back(calc_clip_area(start, size));
+	stats.requested++;
 }
 
 void ClippingManager::pop_clip_area()
@@ -60,34 +67,61 @@ void ClippingManager::pop_clip_area()
 	assert(!clip_areas.empty());
 
 	clip_areas.pop_back();
-	EndScissorMode();
+	stats.requested++;
+}
 
-	// If a previous clip area was present then restore that.
-	if (!clip_areas.empty()) {
-		auto [pos, sz] = clip_areas.back();
-		BeginScissorMode(pos.x, pos.y, sz.x, sz.y);
-	}
+void ClippingManager::commit()
+{
+	if (is_enabled && !clip_areas.empty())
+		apply(clip_areas.back());
+	else
+		apply(std::nullopt);
+}
+
+void ClippingManager::commit_area(Point start, Point size)
+{
+	// Clipping to the whole screen is same as not clipping at all.
+	if (start == Point(0, 0) && size == get_window_size())
+		apply(std::nullopt);
+	else
+		apply(pair(start, size));
+}
+
+void ClippingManager::reset() { apply(std::nullopt); }
+
+void ClippingManager::apply(std::optional<pair<Point, Point>> area)
+{
+	if (area == applied_area)
+		return;
+
+	get_backend().set_clip(area);
+	applied_area = area;
+	stats.applied++;
+}
+
+void ClippingManager::save_clip_areas()
+{
+	saved_clip_areas.push_back(std::move(clip_areas));
+	clip_areas.clear();
+}
+
+void ClippingManager::restore_clip_areas()
+{
+	assert(!saved_clip_areas.empty());
+	clip_areas = std::move(saved_clip_areas.back());
+	saved_clip_areas.pop_back();
 }
 
 void ClippingManager::disable()
 {
 	assert(is_enabled);
 	is_enabled = false;
-
-	if (!clip_areas.empty())
-		EndScissorMode();
 }
 
 void ClippingManager::enable()
 {
 	assert(!is_enabled);
 	is_enabled = true;
-
-	if (clip_areas.empty())
-		return;
-
-	auto [pos, sz] = clip_areas.back();
-	BeginScissorMode(pos.x, pos.y, sz.x, sz.y);
 }
 
 pair<Point, Point> ClippingManager::get_current_clip_region() const
@@ -98,6 +132,14 @@ pair<Point, Point> ClippingManager::get_current_clip_region() const
 		return clip_areas.back();
 }
 
+pair<Point, Point> ClippingManager::get_outermost_clip_region() const
+{
+	if (clip_areas.empty())
+		return pair(Point(0, 0), get_window_size());
+	else
+		return clip_areas.front();
+}
+
 pair<Point, Point>
 ClippingManager::calc_clip_area(Point start, Point size) const
 {
@@ -108,10 +150,238 @@ ClippingManager::calc_clip_area(Point start, Point size) const
 	return new_area;
 }
 
-// Font manager members
+// Translation manager members
+//---------------------------------------------------------
+TranslationManager &TranslationManager::instance()
+{
+	static TranslationManager obj;
+	return obj;
+}
+
+void TranslationManager::push_translation(Point pos)
+{
+	totals.push_back(get_total_translation() + pos);
+}
+
+void TranslationManager::pop_translation()
+{
+	assert(!totals.empty());
+	totals.pop_back();
+}
+
+void TranslationManager::save_translations()
+{
+	saved_totals.push_back(std::move(totals));
+	totals.clear();
+}
+
+void TranslationManager::restore_translations()
+{
+	assert(!saved_totals.empty());
+	totals = std::move(saved_totals.back());
+	saved_totals.pop_back();
+}
+
+// Damage manager members
 //---------------------------------------------------------
-FontManager &FontManager::instance()
+DamageManager &DamageManager::instance()
 {
-	static FontManager obj;
+	static DamageManager obj;
 	return obj;
-}
\ No newline at end of file
+}
+
+void DamageManager::add_area(Point start, Point size)
+{
+	if (size.x <= 0 || size.y <= 0)
+		return;
+
+	// Keep merging with overlapping areas until none overlaps the new area,
+	// since the merged area may start overlapping other areas.
+	auto area = pair(start, size);
+	for (unsigned i = 0; i < areas.size();) {
+		auto [pos, sz] = areas[i];
+		if (check_box_collision(area.first, area.second, pos, sz)) {
+			area = find_bounding_box(area, areas[i]);
+			swap_remove(areas, i);
+			i = 0;
+		} else {
+			i++;
+		}
+	}
+
+	if (areas.size() < MAX_AREAS) {
+		areas.push_back(area);
+		return;
+	}
+
+	for (auto &a : areas)
+		area = find_bounding_box(area, a);
+	areas.clear();
+	areas.push_back(area);
+}
+
+std::vector<pair<Point, Point>> DamageManager::take_areas()
+{
+	return std::exchange(areas, {});
+}
+
+// Tick manager members
+//---------------------------------------------------------
+TickManager &TickManager::instance()
+{
+	static TickManager obj;
+	return obj;
+}
+
+void TickManager::add(Widget *w, std::function<bool()> tick_fn)
+{
+	tickers.push_back({w, std::move(tick_fn)});
+}
+
+void TickManager::add_waiting(
+	Widget *w, const std::atomic<bool> &pending, std::function<bool()> tick_fn
+)
+{
+	tickers.push_back({w, std::move(tick_fn), &pending, true});
+	waiting_count++;
+}
+
+void TickManager::remove(Widget *w)
+{
+	// Only mark them, since we may be in the middle of a tick. Marked ones
+	// are not counted as waiting, as they are about to be erased.
+	for (auto &t : tickers) {
+		if (t.widget != w)
+			continue;
+
+		t.widget = nullptr;
+		if (std::exchange(t.is_waiting, false))
+			waiting_count--;
+	}
+}
+
+void TickManager::tick()
+{
+	for (std::size_t i = 0, n = tickers.size(); i < n; ++i) {
+		if (!tickers[i].widget)
+			continue;
+
+		if (tickers[i].is_waiting) {
+			if (!tickers[i].pending->load(std::memory_order_relaxed))
+				continue;
+			tickers[i].is_waiting = false;
+			waiting_count--;
+		}
+
+		// Functions may add more, so do not hold on to a reference.
+		auto tick_fn = tickers[i].tick_fn;
+		if (tick_fn())
+			continue;
+
+		if (!tickers[i].widget)
+			continue;
+		if (tickers[i].pending) {
+			tickers[i].is_waiting = true;
+			waiting_count++;
+		} else {
+			tickers[i].widget = nullptr;
+		}
+	}
+
+	std::erase_if(tickers, [](const Ticker &t) { return !t.widget; });
+}
+
+// Text metrics manager members
+//---------------------------------------------------------
+TextMetricsManager &TextMetricsManager::instance()
+{
+	static TextMetricsManager obj;
+	return obj;
+}
+
+std::size_t TextMetricsManager::KeyHash::operator()(const Key &key) const
+{
+	auto h = std::hash<std::string_view>{}(key.text);
+	return h ^ (static_cast<std::size_t>(key.font_size) + 0x9e3779b9 + (h << 6));
+}
+
+std::size_t TextMetricsManager::calc_entry_bytes(std::string_view text)
+{
+	// Text along with the list node and the index entry.
+	return text.size() + sizeof(Entry) + 4 * sizeof(void *) + sizeof(Key);
+}
+
+Point TextMetricsManager::measure_text(std::string_view text, FontSize font_size)
+{
+	if (auto it = index.find(Key{text, font_size}); it != index.end()) {
+		stats.hits++;
+		entries.splice(entries.begin(), entries, it->second);
+		return it->second->size;
+	}
+
+	stats.misses++;
+	auto size = measure_uncached(text, font_size);
+
+	// Do not let a huge text evict everything else.
+	auto entry_bytes = calc_entry_bytes(text);
+	if (entry_bytes > MAX_BYTES / 4)
+		return size;
+
+	entries.push_front(Entry{std::string(text), font_size, size});
+	index.emplace(Key{entries.front().text, font_size}, entries.begin());
+	bytes += entry_bytes;
+
+	while (bytes > MAX_BYTES) {
+		auto &old = entries.back();
+		index.erase(Key{old.text, old.font_size});
+		bytes -= calc_entry_bytes(old.text);
+		entries.pop_back();
+		stats.evictions++;
+	}
+
+	return size;
+}
+
+Point TextMetricsManager::measure_uncached(
+	std::string_view text, FontSize font_size
+)
+{
+	// Lines are laid out by the backend.
+	if (text.find('\n') != std::string_view::npos)
+		return get_backend().measure_text(std::string(text).c_str(), font_size);
+
+	float width = 0;
+	for (std::size_t i = 0; i < text.size();)
+		width += get_glyph_advance(decode_utf8(text, i), font_size);
+
+	return Point(width, font_size_to_pixels(font_size));
+}
+
+float TextMetricsManager::get_glyph_advance(int codepoint, FontSize font_size)
+{
+	int idx = static_cast<int>(font_size);
+
+	if (codepoint >= 0 && codepoint < TABLE_GLYPHS) {
+		auto &advance = glyph_table[idx][codepoint];
+		if (advance < 0)
+			advance = get_backend().measure_glyph(codepoint, font_size);
+		return advance;
+	}
+
+	auto [it, inserted] = glyph_maps[idx].try_emplace(codepoint, 0.f);
+	if (inserted)
+		it->second = get_backend().measure_glyph(codepoint, font_size);
+	return it->second;
+}
+
+void TextMetricsManager::clear()
+{
+	entries.clear();
+	index.clear();
+	bytes = 0;
+
+	for (auto &table : glyph_table)
+		std::ranges::fill(table, -1.f);
+	for (auto &map : glyph_maps)
+		map.clear();
+}
@@ -1,16 +1,30 @@
 #ifndef MANAGERS_HXX_INCLUDED
 #define MANAGERS_HXX_INCLUDED
 
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
+#include <optional>
 #include <utility>
 
-#include "raylib/raylib.h"
 #include "point.hxx"
+#include "graphics.hxx"
 
 namespace eggui
 {
 
 /// @brief Nested draw region clipping.
+///
+/// @details
+/// Clip areas are applied lazily. The graphics library is told about the clip
+/// area only when something is about to be drawn and the clip area differs
+/// from the one applied last. Since changing the clip area flushes all the
+/// queued draw calls of the graphics library, we do it only when needed.
 class ClippingManager
 {
 public:
@@ -24,16 +38,41 @@ public:
 	/// @brief Restores the last clip area.
 	void pop_clip_area();
 
+	/// @brief Apply the current clip area if not already applied.
+	/// @note Must be called before drawing anything.
+	void commit();
+	/// @brief Apply the clip area if not already applied, ignoring the pushed
+	///        clip areas. Used for drawing batched draw calls.
+	/// @param start Area start position on screen.
+	/// @param size  Area size.
+	void commit_area(Point start, Point size);
+	/// @brief Remove the applied clip area, if any.
+	void reset();
+
+	const ClipStats &get_stats() const { return stats; }
+	void reset_stats() { stats = ClipStats{}; }
+
+	/// @brief Start afresh without any clip areas, like for drawing offscreen.
+	/// @note Saved clip areas are restored by `restore_clip_areas`.
+	void save_clip_areas();
+	/// @brief Restore the clip areas saved last.
+	void restore_clip_areas();
+
 	/// @brief Temporarily disable clipping.
 	/// @note While clipping is disabled push/pop should not be used.
 	void disable();
-	/// @brief Re-enable clipping and resotre the last clip region.
+	/// @brief Re-enable clipping, the last clip region is restored when
+	///        something is drawn next.
 	void enable();
 
 	/// @brief Get current clip area on screen.
 	/// @return Clip area start and size.
 	/// @note If nothing is being clipped then returns screen area.
 	std::pair<Point, Point> get_current_clip_region() const;
+	/// @brief Get the first clip area pushed, it contains every other area.
+	/// @return Clip area start and size.
+	/// @note If nothing is being clipped then returns screen area.
+	std::pair<Point, Point> get_outermost_clip_region() const;
 
 	/// @brief Just calculate the resulting clipping area, do not apply it.
 	/// @param start Area start position on screen.
@@ -44,41 +83,205 @@ public:
 private:
 	ClippingManager() = default;
 
+	/// @brief Apply the clip area if it differs from the applied one.
+	/// @param area Clip area, nullopt for no clipping.
+	void apply(std::optional<std::pair<Point, Point>> area);
+
 	/// Stores the clip area for each push operation for the purpose of
 	/// restoring them when `pop_clip_area` is called.
 	std::vector<std::pair<Point, Point>> clip_areas;
+	/// Clip areas saved by each `save_clip_areas` call.
+	std::vector<std::vector<std::pair<Point, Point>>> saved_clip_areas;
+	/// Clip area currently applied to the graphics library, if any.
+	std::optional<std::pair<Point, Point>> applied_area;
 	bool is_enabled = true;
+	ClipStats stats;
 };
 
-// class TranslationManager
-// {
-// public:
-// 	static TranslationManager &instance();
+/// @brief Collects screen areas which need to be redrawn.
+class DamageManager
+{
+public:
+	static DamageManager &instance();
 
-// 	void push_translation(Point pos);
-// 	void pop_translation(Point pos);
+	/// @brief Add a damaged area, overlapping areas are merged into one.
+	/// @param start Area start position on screen.
+	/// @param size  Area size.
+	void add_area(Point start, Point size);
 
-// 	Point get_total_translation() const;
+	/// @brief Check if any area has been damaged since the last take.
+	/// @return boolean
+	bool has_damage() const { return !areas.empty(); }
 
-// private:
-// 	TranslationManager() = default;
-// };
+	/// @brief Get all the damaged areas and reset.
+	/// @return Non-overlapping areas as start position and size.
+	std::vector<std::pair<Point, Point>> take_areas();
 
-// TODO complete font manager
-class FontManager
+private:
+	DamageManager() = default;
+
+	/// Beyond this many areas, all areas are merged into their bounding box,
+	/// since each area costs a pass over the widget tree.
+	static constexpr unsigned MAX_AREAS = 8;
+
+	std::vector<std::pair<Point, Point>> areas;
+};
+
+class Widget; // Forward declaration
+
+/// @brief Calls functions of widgets on every update of the window, for
+///        widgets which take in work done by other threads.
+/// The window does not sleep waiting for input events while any are added.
+class TickManager
 {
 public:
-	static FontManager &instance();
+	static TickManager &instance();
 
-	int load_font(
-		const char *file_type, unsigned char *data, int size, int font_size
+	/// @brief Call the function on every update, until it returns false.
+	/// @param w The widget it belongs to.
+	void add(Widget *w, std::function<bool()> tick_fn);
+	/// @brief Call the function on every update once the flag is set, until
+	///        it returns false, and then wait for the flag again. Waiting
+	///        functions do not keep the window from waiting for events.
+	/// @param pending Flag set from any thread, which should then wake the
+	///        window with Backend::wake. The function should clear it.
+	void add_waiting(
+		Widget *w, const std::atomic<bool> &pending,
+		std::function<bool()> tick_fn
 	);
-	void unload_fonts();
+	/// @brief Remove all the functions of the widget, it may be called from
+	///        one of them.
+	void remove(Widget *w);
+
+	/// @brief Call all the functions, functions added meanwhile are called
+	///        from the next tick.
+	void tick();
+	/// @brief Check if any functions are to be called on the next tick,
+	///        waiting ones are called only once their flag is set.
+	bool has_tickers() const { return tickers.size() > waiting_count; }
 
 private:
-	FontManager() { fonts.reserve(8); }
+	TickManager() = default;
+
+	struct Ticker {
+		// Widget the function belongs to, nullptr once removed.
+		Widget *widget;
+		std::function<bool()> tick_fn;
+		// Flag the function waits on, nullptr if it does not wait.
+		const std::atomic<bool> *pending = nullptr;
+		bool is_waiting = false;
+	};
+
+	std::vector<Ticker> tickers;
+	// Number of tickers waiting on their flag.
+	std::size_t waiting_count = 0;
+};
+
+/// @brief Nested translations of drawing positions.
+/// Translations are kept as integers and applied to drawing positions by us,
+/// so there is no limit on how deep translations can be nested.
+class TranslationManager
+{
+public:
+	static TranslationManager &instance();
+
+	/// @brief Apply a translation on top of the current translation.
+	/// @param pos Amount to translate.
+	void push_translation(Point pos);
+	/// @brief Removes the last applied translation.
+	void pop_translation();
+
+	/// @brief Get accumulated translation of all the applied translations.
+	/// @return Total translation.
+	Point get_total_translation() const
+	{
+		return totals.empty() ? Point(0, 0) : totals.back();
+	}
+
+	/// @brief Start afresh without any translation, like for drawing offscreen.
+	/// @note Saved translations are restored by `restore_translations`.
+	void save_translations();
+	/// @brief Restore the translations saved last.
+	void restore_translations();
+
+private:
+	TranslationManager() = default;
+
+	/// Translations saved by each `save_translations` call.
+	std::vector<std::vector<Point>> saved_totals;
+
+	/// Accumulated translation after each push, so that the total need not
+	/// be calculated again every time.
+	std::vector<Point> totals;
+};
+
+/// @brief Caches sizes of texts and advances of glyphs, so that text which
+///        has not changed is never measured again.
+///
+/// @details
+/// Sizes are cached for each text and font size. Once the cached texts take
+/// more than `MAX_BYTES`, the least recently used ones are evicted. Texts not
+/// in the cache are measured by adding up the advances of their glyphs,
+/// which are cached forever since there are few of them.
+class TextMetricsManager
+{
+public:
+	static TextMetricsManager &instance();
+
+	/// @brief Get size of the text when drawn.
+	Point measure_text(std::string_view text, FontSize font_size);
+	/// @brief Get horizontal advance of the glyph.
+	/// @param codepoint Unicode codepoint.
+	float get_glyph_advance(int codepoint, FontSize font_size);
+
+	/// @brief Forget everything measured, like when fonts are reloaded.
+	void clear();
+
+	const TextCacheStats &get_stats() const { return stats; }
+	void reset_stats() { stats = TextCacheStats{}; }
+
+private:
+	TextMetricsManager() { clear(); }
+
+	/// Limit on memory taken by the cached texts.
+	static constexpr std::size_t MAX_BYTES = 256 << 10;
+	/// Glyphs whose advances are kept in a table, instead of a map.
+	static constexpr int TABLE_GLYPHS = 128;
+
+	struct Entry {
+		std::string text;
+		FontSize font_size;
+		Point size;
+	};
+
+	struct Key {
+		std::string_view text;
+		FontSize font_size;
+
+		bool operator==(const Key &) const = default;
+	};
+
+	struct KeyHash {
+		std::size_t operator()(const Key &key) const;
+	};
+
+	/// @brief Memory taken by the entry in the cache.
+	static std::size_t calc_entry_bytes(std::string_view text);
+	/// @brief Measure the text, which is not in the cache.
+	Point measure_uncached(std::string_view text, FontSize font_size);
+
+	/// Cached entries, most recently used first.
+	std::list<Entry> entries;
+	/// Cached entries by text and font size, keys view texts of the entries.
+	std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+	std::size_t bytes = 0;
+
+	/// Advances of the first few glyphs for each font size, negative if not
+	/// measured yet, and advances of the rest of the glyphs.
+	float glyph_table[FONT_SIZE_COUNT][TABLE_GLYPHS];
+	std::unordered_map<int, float> glyph_maps[FONT_SIZE_COUNT];
 
-	std::vector<Font> fonts;
+	TextCacheStats stats;
 };
 
 } // namespace eggui
@@ -0,0 +1,361 @@
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "widget.hxx"
+#include "plot.hxx"
+#include "graphics.hxx"
+#include "managers.hxx"
+#include "backend.hxx"
+
+using namespace eggui;
+
+/// Zoom levels with more columns than this are not cached, since few samples
+/// are shown per column then, and calculating the shown ones is cheap.
+constexpr std::size_t MAX_LEVEL_COLUMNS = 1 << 16;
+/// Number of zoom levels cached.
+constexpr std::size_t MAX_LEVELS = 8;
+
+/// @brief Round the number of samples per column up to a zoom level. Only
+///        the four highest bits are kept, so that levels are at most an
+///        eighth apart, and the level stays the same as samples are added.
+static std::size_t round_up_level(std::size_t per_column)
+{
+	int shift = std::max(0, int(std::bit_width(per_column)) - 4);
+	std::size_t step = std::size_t(1) << shift;
+	return (per_column + step - 1) / step * step;
+}
+
+/// @brief Find the minimum and maximum of the values.
+/// @param n Number of values, at least one.
+static std::pair<float, float> find_min_max(const float *data, std::size_t n)
+{
+	assert(n > 0);
+
+	float low = data[0];
+	float high = data[0];
+	std::size_t i = 0;
+
+#if defined(__AVX2__)
+	if (n >= 8) {
+		auto vlow = _mm256_loadu_ps(data);
+		auto vhigh = vlow;
+		for (i = 8; i + 8 <= n; i += 8) {
+			auto chunk = _mm256_loadu_ps(data + i);
+			vlow = _mm256_min_ps(vlow, chunk);
+			vhigh = _mm256_max_ps(vhigh, chunk);
+		}
+
+		alignas(32) float lows[8], highs[8];
+		_mm256_store_ps(lows, vlow);
+		_mm256_store_ps(highs, vhigh);
+		low = *std::min_element(lows, lows + 8);
+		high = *std::max_element(highs, highs + 8);
+	}
+#elif defined(__SSE2__)
+	if (n >= 4) {
+		auto vlow = _mm_loadu_ps(data);
+		auto vhigh = vlow;
+		for (i = 4; i + 4 <= n; i += 4) {
+			auto chunk = _mm_loadu_ps(data + i);
+			vlow = _mm_min_ps(vlow, chunk);
+			vhigh = _mm_max_ps(vhigh, chunk);
+		}
+
+		alignas(16) float lows[4], highs[4];
+		_mm_store_ps(lows, vlow);
+		_mm_store_ps(highs, vhigh);
+		low = *std::min_element(lows, lows + 4);
+		high = *std::max_element(highs, highs + 4);
+	}
+#endif
+
+	for (; i < n; ++i) {
+		low = std::min(low, data[i]);
+		high = std::max(high, data[i]);
+	}
+
+	return std::pair(low, high);
+}
+
+// Plot members
+//---------------------------------------------------------
+struct Plot::Incoming {
+	std::mutex mutex;
+	std::vector<float> samples;
+	// Set once samples are appended, until the plot takes them.
+	std::atomic<bool> pending = false;
+};
+
+Plot::Plot(int w, int h, RGBA color_)
+	: Widget(w, h)
+	, incoming(std::make_unique<Incoming>())
+	, color(color_)
+{
+	// Samples may be appended at any time, appending wakes us to take them.
+	TickManager::instance().add_waiting(this, incoming->pending, [this]() {
+		take_samples();
+		return false;
+	});
+}
+
+Plot::~Plot() { TickManager::instance().remove(this); }
+
+void Plot::append(std::span<const float> values)
+{
+	bool was_pending;
+	{
+		std::lock_guard lock(incoming->mutex);
+		auto &found = incoming->samples;
+		found.insert(found.end(), values.begin(), values.end());
+		was_pending = incoming->pending.exchange(true);
+	}
+
+	// Only the first samples appended since the plot last took them wake it.
+	if (!was_pending)
+		get_backend().wake();
+}
+
+void Plot::clear()
+{
+	{
+		std::lock_guard lock(incoming->mutex);
+		incoming->samples.clear();
+	}
+
+	samples.clear();
+	levels.clear();
+	mark_damaged();
+}
+
+void Plot::show_all()
+{
+	range = Range::All;
+	mark_damaged();
+}
+
+void Plot::show_latest(std::size_t count)
+{
+	range = Range::Latest;
+	range_count = count;
+	mark_damaged();
+}
+
+void Plot::show_range(std::size_t first, std::size_t count)
+{
+	range = Range::Fixed;
+	range_first = first;
+	range_count = count;
+	mark_damaged();
+}
+
+void Plot::set_value_range(float low, float high)
+{
+	assert(low < high);
+
+	is_value_range_fixed = true;
+	value_low = low;
+	value_high = high;
+	mark_damaged();
+}
+
+void Plot::fit_value_range()
+{
+	is_value_range_fixed = false;
+	mark_damaged();
+}
+
+void Plot::take_samples()
+{
+	{
+		std::lock_guard lock(incoming->mutex);
+		incoming->pending = false;
+		if (incoming->samples.empty())
+			return;
+
+		auto &found = incoming->samples;
+		samples.insert(samples.end(), found.begin(), found.end());
+		found.clear();
+	}
+
+	// Bars of cached levels are brought up to date once drawn.
+	mark_damaged();
+}
+
+std::pair<std::size_t, std::size_t> Plot::calc_shown_samples() const
+{
+	std::size_t count = samples.size();
+	switch (range) {
+	case Range::All:
+		return std::pair(0, count);
+	case Range::Latest:
+		return std::pair(count - std::min(count, range_count), range_count);
+	case Range::Fixed:
+		return std::pair(range_first, range_count);
+	}
+
+	return std::pair(0, count);
+}
+
+void Plot::calc_columns(
+	std::size_t per_column, std::size_t first, std::size_t last, float *mins,
+	float *maxs
+)
+{
+	for (auto col = first; col < last; ++col) {
+		auto start = col * per_column;
+		auto end = std::min(samples.size(), start + per_column);
+		std::tie(mins[col - first], maxs[col - first]) = find_min_max(
+			samples.data() + start, end - start
+		);
+	}
+
+	columns_calculated += last - first;
+}
+
+Plot::Level &Plot::get_level(std::size_t per_column)
+{
+	auto &level = levels[per_column];
+	level.last_used = ++use_count;
+
+	// The last column may have got more samples, and new columns may have
+	// been started since the bars were calculated.
+	std::size_t first = level.sample_count / per_column;
+	std::size_t last = (samples.size() + per_column - 1) / per_column;
+	if (level.sample_count < samples.size()) {
+		level.mins.resize(last);
+		level.maxs.resize(last);
+		calc_columns(
+			per_column, first, last, level.mins.data() + first,
+			level.maxs.data() + first
+		);
+		level.sample_count = samples.size();
+	}
+
+	if (levels.size() > MAX_LEVELS) {
+		auto oldest = std::ranges::min_element(levels, {}, [](auto &entry) {
+			return entry.second.last_used;
+		});
+		levels.erase(oldest);
+	}
+
+	return level;
+}
+
+float Plot::value_to_ypos(float value, float low, float high) const
+{
+	float height = get_size().y - 1;
+	return height - (value - low) / (high - low) * height;
+}
+
+void Plot::draw()
+{
+	auto [first, count] = calc_shown_samples();
+	first = std::min(first, samples.size());
+	count = std::min(count, samples.size() - first);
+	if (count == 0)
+		return;
+
+	// Samples are drawn as they are if there are few enough to be seen.
+	if (count <= std::size_t(get_size().x))
+		draw_samples(first, count);
+	else
+		draw_columns(first, count);
+}
+
+void Plot::draw_samples(std::size_t first, std::size_t count)
+{
+	auto [low, high] = find_min_max(samples.data() + first, count);
+	if (is_value_range_fixed)
+		std::tie(low, high) = std::pair(value_low, value_high);
+	if (low == high)
+		high = low + 1;
+
+	// Spread the samples over the width.
+	float step = count > 1 ? float(get_size().x - 1) / (count - 1) : 0;
+	Point last(0, value_to_ypos(samples[first], low, high));
+	for (std::size_t i = 1; i < count; ++i) {
+		Point pos(i * step, value_to_ypos(samples[first + i], low, high));
+		draw_line(last, pos, color);
+		last = pos;
+	}
+	if (count == 1)
+		draw_rect(last, Point(1, 1), color);
+}
+
+void Plot::draw_columns(std::size_t first, std::size_t count)
+{
+	int width = get_size().x;
+	auto per_column = round_up_level((count + width - 1) / width);
+
+	// Columns start at multiples of the samples per column, so that they
+	// are the same however the view is panned.
+	std::size_t first_col = first / per_column;
+	std::size_t last_col = std::min(
+		(first + count + per_column - 1) / per_column,
+		(samples.size() + per_column - 1) / per_column
+	);
+
+	const float *mins;
+	const float *maxs;
+	if (samples.size() / per_column <= MAX_LEVEL_COLUMNS) {
+		auto &level = get_level(per_column);
+		mins = level.mins.data() + first_col;
+		maxs = level.maxs.data() + first_col;
+	} else {
+		scratch_mins.resize(last_col - first_col);
+		scratch_maxs.resize(last_col - first_col);
+		calc_columns(
+			per_column, first_col, last_col, scratch_mins.data(),
+			scratch_maxs.data()
+		);
+		mins = scratch_mins.data();
+		maxs = scratch_maxs.data();
+	}
+
+	int cols = last_col - first_col;
+	float low = value_low;
+	float high = value_high;
+	if (!is_value_range_fixed) {
+		low = *std::min_element(mins, mins + cols);
+		high = *std::max_element(maxs, maxs + cols);
+	}
+	if (low == high)
+		high = low + 1;
+
+	// Columns are a bit wider than a pixel, since levels are rounded up.
+	auto col_to_xpos = [&](std::size_t col) {
+		double offset = double(col * per_column) - double(first);
+		return std::max(0, int(offset * width / count));
+	};
+
+	// Each bar reaches the previous one, so that the line looks unbroken.
+	int xpos = col_to_xpos(first_col);
+	for (int i = 0; i < cols; ++i) {
+		float bar_low = mins[i];
+		float bar_high = maxs[i];
+		if (i > 0) {
+			bar_low = std::min(bar_low, maxs[i - 1]);
+			bar_high = std::max(bar_high, mins[i - 1]);
+		}
+
+		int next_xpos = std::max(xpos + 1, col_to_xpos(first_col + i + 1));
+		int top = value_to_ypos(bar_high, low, high);
+		int bottom = value_to_ypos(bar_low, low, high);
+		Point size(next_xpos - xpos, bottom - top + 1);
+		draw_rect(Point(xpos, top), size, color);
+		xpos = next_xpos;
+	}
+}
@@ -0,0 +1,855 @@
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <optional>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "raster.hxx"
+
+using namespace eggui;
+
+static_assert(sizeof(RGBA) == 4, "Pixels are handled as 4 bytes by kernels.");
+
+/// Pixels whose coverage is calculated in one go.
+constexpr int COVERAGE_CHUNK = 64;
+
+/// Use the vectorized kernels, if compiled in.
+static bool g_is_simd_enabled = true;
+
+// Pixel arithmetic
+//---------------------------------------------------------
+/// @brief Divide by 255 with rounding, exact for products of two bytes.
+inline unsigned div255(unsigned x)
+{
+	x += 128;
+	return (x + (x >> 8)) >> 8;
+}
+
+/// @brief Draw the color over the pixel using the alpha given.
+inline RGBA blend_pixel(RGBA dst, RGBA src, unsigned alpha)
+{
+	unsigned inv = 255 - alpha;
+	return RGBA(
+		div255(src.r * alpha + dst.r * inv),
+		div255(src.g * alpha + dst.g * inv),
+		div255(src.b * alpha + dst.b * inv),
+		div255(255 * alpha + dst.a * inv)
+	);
+}
+
+inline std::uint8_t to_coverage(float cov)
+{
+	return std::clamp(cov, 0.f, 1.f) * 255 + 0.5f;
+}
+
+inline RGBA *pixel_at(const Surface &s, int x, int y)
+{
+	return s.pixels + static_cast<std::ptrdiff_t>(y) * s.size.x + x;
+}
+
+inline bool is_row_clipped(const Surface &s, int y)
+{
+	return y < s.clip_lo.y || y >= s.clip_hi.y;
+}
+
+/// @brief Draw a span of the row, with every pixel fully covered.
+static void paint_span(const Surface &s, int y, int x0, int x1, RGBA color)
+{
+	x0 = std::max(x0, s.clip_lo.x);
+	x1 = std::min(x1, s.clip_hi.x);
+	if (x0 < x1 && !is_row_clipped(s, y))
+		blend_span(pixel_at(s, x0, y), x1 - x0, color);
+}
+
+/// @brief Draw a span of the row, coverage of the pixels is calculated by
+///        the callback `coverage(x, cov, n)` for `n` pixels from `x` onwards.
+template <typename CoverageFn>
+static void paint_span_coverage(
+	const Surface &s, int y, int x0, int x1, RGBA color, CoverageFn &&coverage
+)
+{
+	x0 = std::max(x0, s.clip_lo.x);
+	x1 = std::min(x1, s.clip_hi.x);
+	if (x0 >= x1 || is_row_clipped(s, y))
+		return;
+
+	std::uint8_t cov[COVERAGE_CHUNK];
+	for (int x = x0; x < x1; x += COVERAGE_CHUNK) {
+		int n = std::min(COVERAGE_CHUNK, x1 - x);
+		coverage(x, cov, n);
+		blend_span_coverage(pixel_at(s, x, y), cov, n, color);
+	}
+}
+
+// Rounded boxes
+// Rounded rects and circles are boxes with rounded corners, pixels are
+// covered as per their distance from the box edge.
+//---------------------------------------------------------
+struct RoundedBox {
+	// Center and half of the size.
+	float cx;
+	float cy;
+	float hw;
+	float hh;
+	// Corner radius.
+	float r;
+};
+
+/// @brief Signed distance of the point from the box edge, negative inside.
+inline float calc_box_distance(const RoundedBox &b, float x, float y)
+{
+	float qx = std::abs(x - b.cx) - (b.hw - b.r);
+	float qy = std::abs(y - b.cy) - (b.hh - b.r);
+	float ox = std::max(qx, 0.f);
+	float oy = std::max(qy, 0.f);
+	return std::sqrt(ox * ox + oy * oy) + std::min(std::max(qx, qy), 0.f) - b.r;
+}
+
+/// @brief Half width of the row of the box grown by the amount.
+/// @param qy Distance of the row from the straight part of the box.
+/// @return Negative if the row lies outside of the grown box.
+inline float calc_box_half_width(const RoundedBox &b, float qy, float grow)
+{
+	float rr = b.r + grow;
+	if (qy <= 0)
+		return qy <= rr ? b.hw - b.r + rr : -1;
+
+	float ext = rr * rr - qy * qy;
+	return rr < 0 || ext < 0 ? -1 : b.hw - b.r + std::sqrt(ext);
+}
+
+/// @brief Pixels of a row which a rounded box covers.
+struct BoxSpan {
+	// Pixels covered partially or fully, from x0 to x1(exclusive).
+	int x0;
+	int x1;
+	// Pixels covered fully, lies inside of the above span.
+	int solid_x0;
+	int solid_x1;
+};
+
+/// @brief Find pixels of the row covered by the box.
+/// @return nullopt if the row does not touch the box.
+static std::optional<BoxSpan> find_box_span(const RoundedBox &b, int y)
+{
+	float qy = std::abs(y + 0.5f - b.cy) - (b.hh - b.r);
+
+	// Pixel centers within half a pixel of the box edge are covered.
+	float outer = calc_box_half_width(b, qy, 0.5f);
+	if (outer < 0)
+		return std::nullopt;
+
+	BoxSpan span;
+	span.x0 = std::floor(b.cx - outer + 0.5f);
+	span.x1 = std::ceil(b.cx + outer - 0.5f);
+	span.solid_x0 = span.solid_x1 = span.x1;
+
+	if (float inner = calc_box_half_width(b, qy, -0.5f); inner >= 0) {
+		int lo = std::ceil(b.cx - inner - 0.5f);
+		int hi = std::floor(b.cx + inner - 0.5f) + 1;
+		span.solid_x0 = std::clamp(lo, span.x0, span.x1);
+		span.solid_x1 = std::clamp(hi, span.solid_x0, span.x1);
+	}
+
+	return span;
+}
+
+/// @brief Get the rows the box touches, clipped to the surface clip area.
+inline std::pair<int, int> find_box_rows(const Surface &s, const RoundedBox &b)
+{
+	int y0 = std::max<int>(std::floor(b.cy - b.hh), s.clip_lo.y);
+	int y1 = std::min<int>(std::ceil(b.cy + b.hh), s.clip_hi.y);
+	return {y0, y1};
+}
+
+// Scalar kernels
+//---------------------------------------------------------
+static void blend_span_scalar(RGBA *dst, int n, RGBA color)
+{
+	if (color.a == 255) {
+		std::fill_n(dst, n, color);
+		return;
+	}
+
+	for (int i = 0; i < n; ++i)
+		dst[i] = blend_pixel(dst[i], color, color.a);
+}
+
+static void blend_span_coverage_scalar(
+	RGBA *dst, const std::uint8_t *coverage, int n, RGBA color
+)
+{
+	for (int i = 0; i < n; ++i) {
+		if (unsigned alpha = div255(color.a * coverage[i]))
+			dst[i] = blend_pixel(dst[i], color, alpha);
+	}
+}
+
+static void blend_span_pixels_scalar(RGBA *dst, const RGBA *src, int n)
+{
+	for (int i = 0; i < n; ++i)
+		dst[i] = blend_pixel(dst[i], src[i], src[i].a);
+}
+
+/// @brief Calculate coverage of `n` pixels of the row from `x` onwards.
+static void calc_box_coverage_scalar(
+	const RoundedBox &b, int x, float py, std::uint8_t *cov, int n
+)
+{
+	for (int i = 0; i < n; ++i)
+		cov[i] = to_coverage(0.5f - calc_box_distance(b, x + i + 0.5f, py));
+}
+
+// Vectorized kernels
+// Pixels are widened to 16-bit channels, so that the products of blending
+// fit, and are narrowed back after dividing by 255. They give the same
+// results as the scalar kernels, which handle the pixels left at the end.
+//---------------------------------------------------------
+#if defined(__AVX2__)
+constexpr const char *SIMD_NAME = "AVX2";
+
+inline __m256i div255_epu16(__m256i x)
+{
+	x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+	return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+/// @brief Blend widened pixels, alpha channel of the source must be 255.
+inline __m256i blend_epu16(__m256i dst, __m256i src, __m256i alpha)
+{
+	auto inv = _mm256_sub_epi16(_mm256_set1_epi16(255), alpha);
+	return div255_epu16(_mm256_add_epi16(
+		_mm256_mullo_epi16(src, alpha), _mm256_mullo_epi16(dst, inv)
+	));
+}
+
+/// @brief Load 4 pixels widened to 16-bit channels.
+inline __m256i load_widened(const RGBA *p)
+{
+	return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)p));
+}
+
+/// @brief Store 4 widened pixels.
+inline void store_narrowed(RGBA *p, __m256i v)
+{
+	auto lo = _mm256_castsi256_si128(v);
+	auto hi = _mm256_extracti128_si256(v, 1);
+	_mm_storeu_si128((__m128i *)p, _mm_packus_epi16(lo, hi));
+}
+
+/// @brief Widen a color to 16-bit channels of 4 pixels, with alpha 255.
+inline __m256i widen_color(RGBA c)
+{
+	long long channels = c.r | c.g << 16 | (long long)c.b << 32
+						 | 255LL << 48;
+	return _mm256_set1_epi64x(channels);
+}
+
+/// @brief Load coverage of 4 pixels widened and repeated for each channel.
+inline __m256i load_coverage(const std::uint8_t *cov)
+{
+	int c;
+	std::memcpy(&c, cov, 4);
+	auto v = _mm_cvtsi32_si128(c);
+	v = _mm_unpacklo_epi8(v, v);
+	return _mm256_cvtepu8_epi16(_mm_unpacklo_epi16(v, v));
+}
+
+static void blend_span_simd(RGBA *dst, int n, RGBA color)
+{
+	int i = 0;
+	if (color.a == 255) {
+		int bits;
+		std::memcpy(&bits, &color, 4);
+		auto c = _mm256_set1_epi32(bits);
+		for (; i + 8 <= n; i += 8)
+			_mm256_storeu_si256((__m256i *)(dst + i), c);
+	} else {
+		// The source part of the blend is the same for every pixel.
+		auto src = _mm256_mullo_epi16(
+			widen_color(color), _mm256_set1_epi16(color.a)
+		);
+		auto inv = _mm256_set1_epi16(255 - color.a);
+		for (; i + 4 <= n; i += 4) {
+			auto d = _mm256_mullo_epi16(load_widened(dst + i), inv);
+			store_narrowed(dst + i, div255_epu16(_mm256_add_epi16(src, d)));
+		}
+	}
+
+	blend_span_scalar(dst + i, n - i, color);
+}
+
+static void blend_span_coverage_simd(
+	RGBA *dst, const std::uint8_t *coverage, int n, RGBA color
+)
+{
+	auto src = widen_color(color);
+	auto ca = _mm256_set1_epi16(color.a);
+	int opaque;
+	std::memcpy(&opaque, &color, 4);
+
+	int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		int c;
+		std::memcpy(&c, coverage + i, 4);
+		if (c == 0)
+			continue;
+		if (c == -1 && color.a == 255) {
+			_mm_storeu_si128((__m128i *)(dst + i), _mm_set1_epi32(opaque));
+			continue;
+		}
+
+		auto alpha = div255_epu16(
+			_mm256_mullo_epi16(load_coverage(coverage + i), ca)
+		);
+		store_narrowed(dst + i, blend_epu16(load_widened(dst + i), src, alpha));
+	}
+
+	blend_span_coverage_scalar(dst + i, coverage + i, n - i, color);
+}
+
+static void blend_span_pixels_simd(RGBA *dst, const RGBA *src, int n)
+{
+	auto alpha_mask = _mm256_set1_epi64x(0xFFLL << 48);
+
+	int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		// Opaque pixels are just copied.
+		auto raw = _mm_loadu_si128((const __m128i *)(src + i));
+		auto is_opaque = _mm_cmpeq_epi8(raw, _mm_set1_epi8(-1));
+		if ((_mm_movemask_epi8(is_opaque) & 0x8888) == 0x8888) {
+			_mm_storeu_si128((__m128i *)(dst + i), raw);
+			continue;
+		}
+
+		auto s = _mm256_cvtepu8_epi16(raw);
+		auto alpha = _mm256_shufflehi_epi16(
+			_mm256_shufflelo_epi16(s, 0xFF), 0xFF
+		);
+		s = _mm256_or_si256(s, alpha_mask);
+		store_narrowed(dst + i, blend_epu16(load_widened(dst + i), s, alpha));
+	}
+
+	blend_span_pixels_scalar(dst + i, src + i, n - i);
+}
+
+static void calc_box_coverage_simd(
+	const RoundedBox &b, int x, float py, std::uint8_t *cov, int n
+)
+{
+	// Distance from the straight part along y is the same for the whole row.
+	float qy = std::abs(py - b.cy) - (b.hh - b.r);
+	float oy = std::max(qy, 0.f);
+
+	auto vqy = _mm256_set1_ps(qy);
+	auto oy2 = _mm256_set1_ps(oy * oy);
+	auto cx = _mm256_set1_ps(b.cx);
+	auto inset = _mm256_set1_ps(b.hw - b.r);
+	auto r = _mm256_set1_ps(b.r);
+	auto zero = _mm256_setzero_ps();
+	auto one = _mm256_set1_ps(1);
+	auto half = _mm256_set1_ps(0.5f);
+	auto full = _mm256_set1_ps(255);
+	auto sign = _mm256_set1_ps(-0.f);
+	auto centers = _mm256_setr_ps(
+		0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f
+	);
+
+	int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		auto px = _mm256_add_ps(_mm256_set1_ps(x + i), centers);
+		auto qx = _mm256_sub_ps(
+			_mm256_andnot_ps(sign, _mm256_sub_ps(px, cx)), inset
+		);
+		auto ox = _mm256_max_ps(qx, zero);
+		auto d = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(ox, ox), oy2));
+		d = _mm256_add_ps(d, _mm256_min_ps(_mm256_max_ps(qx, vqy), zero));
+		d = _mm256_sub_ps(d, r);
+
+		auto c = _mm256_min_ps(
+			_mm256_max_ps(_mm256_sub_ps(half, d), zero), one
+		);
+		auto ci = _mm256_cvttps_epi32(
+			_mm256_add_ps(_mm256_mul_ps(c, full), half)
+		);
+		auto words = _mm_packs_epi32(
+			_mm256_castsi256_si128(ci), _mm256_extracti128_si256(ci, 1)
+		);
+		_mm_storel_epi64((__m128i *)(cov + i), _mm_packus_epi16(words, words));
+	}
+
+	calc_box_coverage_scalar(b, x + i, py, cov + i, n - i);
+}
+
+#elif defined(__SSE2__)
+constexpr const char *SIMD_NAME = "SSE2";
+
+inline __m128i div255_epu16(__m128i x)
+{
+	x = _mm_add_epi16(x, _mm_set1_epi16(128));
+	return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+/// @brief Blend widened pixels, alpha channel of the source must be 255.
+inline __m128i blend_epu16(__m128i dst, __m128i src, __m128i alpha)
+{
+	auto inv = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+	return div255_epu16(
+		_mm_add_epi16(_mm_mullo_epi16(src, alpha), _mm_mullo_epi16(dst, inv))
+	);
+}
+
+/// @brief Widen a color to 16-bit channels of 2 pixels, with alpha 255.
+inline __m128i widen_color(RGBA c)
+{
+	long long channels = c.r | c.g << 16 | (long long)c.b << 32
+						 | 255LL << 48;
+	return _mm_set1_epi64x(channels);
+}
+
+static void blend_span_simd(RGBA *dst, int n, RGBA color)
+{
+	int i = 0;
+	if (color.a == 255) {
+		int bits;
+		std::memcpy(&bits, &color, 4);
+		auto c = _mm_set1_epi32(bits);
+		for (; i + 4 <= n; i += 4)
+			_mm_storeu_si128((__m128i *)(dst + i), c);
+	} else {
+		// The source part of the blend is the same for every pixel.
+		auto src = _mm_mullo_epi16(widen_color(color), _mm_set1_epi16(color.a));
+		auto inv = _mm_set1_epi16(255 - color.a);
+		auto zero = _mm_setzero_si128();
+		for (; i + 4 <= n; i += 4) {
+			auto p = _mm_loadu_si128((const __m128i *)(dst + i));
+			auto lo = _mm_mullo_epi16(_mm_unpacklo_epi8(p, zero), inv);
+			auto hi = _mm_mullo_epi16(_mm_unpackhi_epi8(p, zero), inv);
+			lo = div255_epu16(_mm_add_epi16(src, lo));
+			hi = div255_epu16(_mm_add_epi16(src, hi));
+			_mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(lo, hi));
+		}
+	}
+
+	blend_span_scalar(dst + i, n - i, color);
+}
+
+static void blend_span_coverage_simd(
+	RGBA *dst, const std::uint8_t *coverage, int n, RGBA color
+)
+{
+	auto src = widen_color(color);
+	auto ca = _mm_set1_epi16(color.a);
+	auto zero = _mm_setzero_si128();
+	int opaque;
+	std::memcpy(&opaque, &color, 4);
+
+	int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		int c;
+		std::memcpy(&c, coverage + i, 4);
+		if (c == 0)
+			continue;
+		if (c == -1 && color.a == 255) {
+			_mm_storeu_si128((__m128i *)(dst + i), _mm_set1_epi32(opaque));
+			continue;
+		}
+
+		// Coverage of each pixel repeated for its 4 channels.
+		auto cov = _mm_cvtsi32_si128(c);
+		cov = _mm_unpacklo_epi8(cov, cov);
+		cov = _mm_unpacklo_epi16(cov, cov);
+		auto a_lo = div255_epu16(
+			_mm_mullo_epi16(_mm_unpacklo_epi8(cov, zero), ca)
+		);
+		auto a_hi = div255_epu16(
+			_mm_mullo_epi16(_mm_unpackhi_epi8(cov, zero), ca)
+		);
+
+		auto p = _mm_loadu_si128((const __m128i *)(dst + i));
+		auto lo = blend_epu16(_mm_unpacklo_epi8(p, zero), src, a_lo);
+		auto hi = blend_epu16(_mm_unpackhi_epi8(p, zero), src, a_hi);
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(lo, hi));
+	}
+
+	blend_span_coverage_scalar(dst + i, coverage + i, n - i, color);
+}
+
+static void blend_span_pixels_simd(RGBA *dst, const RGBA *src, int n)
+{
+	auto alpha_mask = _mm_set1_epi64x(0xFFLL << 48);
+	auto zero = _mm_setzero_si128();
+
+	int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		// Opaque pixels are just copied.
+		auto s = _mm_loadu_si128((const __m128i *)(src + i));
+		auto is_opaque = _mm_cmpeq_epi8(s, _mm_set1_epi8(-1));
+		if ((_mm_movemask_epi8(is_opaque) & 0x8888) == 0x8888) {
+			_mm_storeu_si128((__m128i *)(dst + i), s);
+			continue;
+		}
+
+		auto s_lo = _mm_unpacklo_epi8(s, zero);
+		auto s_hi = _mm_unpackhi_epi8(s, zero);
+		auto a_lo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s_lo, 0xFF), 0xFF);
+		auto a_hi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s_hi, 0xFF), 0xFF);
+
+		auto p = _mm_loadu_si128((const __m128i *)(dst + i));
+		auto lo = _mm_or_si128(s_lo, alpha_mask);
+		auto hi = _mm_or_si128(s_hi, alpha_mask);
+		lo = blend_epu16(_mm_unpacklo_epi8(p, zero), lo, a_lo);
+		hi = blend_epu16(_mm_unpackhi_epi8(p, zero), hi, a_hi);
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(lo, hi));
+	}
+
+	blend_span_pixels_scalar(dst + i, src + i, n - i);
+}
+
+static void calc_box_coverage_simd(
+	const RoundedBox &b, int x, float py, std::uint8_t *cov, int n
+)
+{
+	// Distance from the straight part along y is the same for the whole row.
+	float qy = std::abs(py - b.cy) - (b.hh - b.r);
+	float oy = std::max(qy, 0.f);
+
+	auto vqy = _mm_set1_ps(qy);
+	auto oy2 = _mm_set1_ps(oy * oy);
+	auto cx = _mm_set1_ps(b.cx);
+	auto inset = _mm_set1_ps(b.hw - b.r);
+	auto r = _mm_set1_ps(b.r);
+	auto zero = _mm_setzero_ps();
+	auto one = _mm_set1_ps(1);
+	auto half = _mm_set1_ps(0.5f);
+	auto full = _mm_set1_ps(255);
+	auto sign = _mm_set1_ps(-0.f);
+	auto centers = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+	int i = 0;
+	for (; i + 4 <= n; i += 4) {
+		auto px = _mm_add_ps(_mm_set1_ps(x + i), centers);
+		auto qx = _mm_sub_ps(_mm_andnot_ps(sign, _mm_sub_ps(px, cx)), inset);
+		auto ox = _mm_max_ps(qx, zero);
+		auto d = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(ox, ox), oy2));
+		d = _mm_add_ps(d, _mm_min_ps(_mm_max_ps(qx, vqy), zero));
+		d = _mm_sub_ps(d, r);
+
+		auto c = _mm_min_ps(_mm_max_ps(_mm_sub_ps(half, d), zero), one);
+		auto ci = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(c, full), half));
+		auto words = _mm_packs_epi32(ci, ci);
+		int bytes = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+		std::memcpy(cov + i, &bytes, 4);
+	}
+
+	calc_box_coverage_scalar(b, x + i, py, cov + i, n - i);
+}
+
+#else
+constexpr const char *SIMD_NAME = nullptr;
+#endif
+
+/// @brief Calculate coverage of `n` pixels of the row from `x` onwards.
+static void calc_box_coverage(
+	const RoundedBox &b, int x, float py, std::uint8_t *cov, int n
+)
+{
+#if defined(__SSE2__)
+	if (g_is_simd_enabled)
+		return calc_box_coverage_simd(b, x, py, cov, n);
+#endif
+	calc_box_coverage_scalar(b, x, py, cov, n);
+}
+
+static void raster_box(const Surface &s, const RoundedBox &b, RGBA color)
+{
+	auto [y0, y1] = find_box_rows(s, b);
+	for (int y = y0; y < y1; ++y) {
+		auto span = find_box_span(b, y);
+		if (!span)
+			continue;
+
+		float py = y + 0.5f;
+		auto coverage = [&b, py](int x, std::uint8_t *cov, int n) {
+			calc_box_coverage(b, x, py, cov, n);
+		};
+
+		paint_span_coverage(s, y, span->x0, span->solid_x0, color, coverage);
+		paint_span(s, y, span->solid_x0, span->solid_x1, color);
+		paint_span_coverage(s, y, span->solid_x1, span->x1, color, coverage);
+	}
+}
+
+inline RoundedBox make_circle(Point center, float radius)
+{
+	return RoundedBox{
+		.cx = float(center.x),
+		.cy = float(center.y),
+		.hw = radius,
+		.hh = radius,
+		.r = radius,
+	};
+}
+
+namespace eggui
+{
+// Span kernels
+//---------------------------------------------------------
+void blend_span(RGBA *dst, int n, RGBA color)
+{
+#if defined(__SSE2__)
+	if (g_is_simd_enabled)
+		return blend_span_simd(dst, n, color);
+#endif
+	blend_span_scalar(dst, n, color);
+}
+
+void blend_span_coverage(
+	RGBA *dst, const std::uint8_t *coverage, int n, RGBA color
+)
+{
+#if defined(__SSE2__)
+	if (g_is_simd_enabled)
+		return blend_span_coverage_simd(dst, coverage, n, color);
+#endif
+	blend_span_coverage_scalar(dst, coverage, n, color);
+}
+
+void blend_span_pixels(RGBA *dst, const RGBA *src, int n)
+{
+#if defined(__SSE2__)
+	if (g_is_simd_enabled)
+		return blend_span_pixels_simd(dst, src, n);
+#endif
+	blend_span_pixels_scalar(dst, src, n);
+}
+
+void set_simd_enabled(bool enable) { g_is_simd_enabled = enable; }
+
+const char *get_simd_name()
+{
+	return g_is_simd_enabled ? SIMD_NAME : nullptr;
+}
+
+// Shapes
+//---------------------------------------------------------
+void raster_pixel(const Surface &s, Point pos, RGBA color)
+{
+	paint_span(s, pos.y, pos.x, pos.x + 1, color);
+}
+
+void raster_line(const Surface &s, Point start, Point end, RGBA color)
+{
+	// Bresenham's line algorithm.
+	int dx = std::abs(end.x - start.x);
+	int dy = -std::abs(end.y - start.y);
+	int sx = start.x < end.x ? 1 : -1;
+	int sy = start.y < end.y ? 1 : -1;
+	int err = dx + dy;
+
+	for (auto p = start;; ) {
+		raster_pixel(s, p, color);
+		if (p == end)
+			break;
+
+		int e2 = 2 * err;
+		if (e2 >= dy) {
+			err += dy;
+			p.x += sx;
+		}
+		if (e2 <= dx) {
+			err += dx;
+			p.y += sy;
+		}
+	}
+}
+
+void raster_rect(const Surface &s, Point pos, Point size, RGBA color)
+{
+	int y0 = std::max(pos.y, s.clip_lo.y);
+	int y1 = std::min(pos.y + size.y, s.clip_hi.y);
+	for (int y = y0; y < y1; ++y)
+		paint_span(s, y, pos.x, pos.x + size.x, color);
+}
+
+void raster_rect_lines(const Surface &s, Point pos, Point size, RGBA color)
+{
+	if (size.x <= 0 || size.y <= 0)
+		return;
+
+	raster_rect(s, pos, Point(size.x, 1), color);
+	if (size.y == 1)
+		return;
+
+	raster_rect(s, pos + Point(0, size.y - 1), Point(size.x, 1), color);
+	raster_rect(s, pos + Point(0, 1), Point(1, size.y - 2), color);
+	if (size.x > 1)
+		raster_rect(s, pos + Point(size.x - 1, 1), Point(1, size.y - 2), color);
+}
+
+void raster_rounded_rect(
+	const Surface &s, Point pos, Point size, float radius, RGBA color
+)
+{
+	if (size.x <= 0 || size.y <= 0)
+		return;
+
+	RoundedBox box{
+		.cx = pos.x + size.x / 2.f,
+		.cy = pos.y + size.y / 2.f,
+		.hw = size.x / 2.f,
+		.hh = size.y / 2.f,
+		.r = std::clamp(radius, 0.f, std::min(size.x, size.y) / 2.f),
+	};
+	raster_box(s, box, color);
+}
+
+void raster_circle(const Surface &s, Point center, float radius, RGBA color)
+{
+	if (radius > 0)
+		raster_box(s, make_circle(center, radius), color);
+}
+
+void raster_circle_sector(
+	const Surface &s, Point center, float radius, float start_angle,
+	float end_angle, RGBA color
+)
+{
+	if (radius <= 0)
+		return;
+
+	float lo = std::min(start_angle, end_angle);
+	float sweep = std::abs(end_angle - start_angle);
+	auto is_in_sector = [=](float x, float y) {
+		if (sweep >= 360)
+			return true;
+
+		// Angle from the start angle, in [0, 360).
+		float angle = std::atan2(y, x) * 180 / 3.14159265f - lo;
+		angle = std::fmod(angle, 360.f);
+		if (angle < 0)
+			angle += 360;
+		return angle <= sweep;
+	};
+
+	auto circle = make_circle(center, radius);
+	auto [y0, y1] = find_box_rows(s, circle);
+	for (int y = y0; y < y1; ++y) {
+		auto span = find_box_span(circle, y);
+		if (!span)
+			continue;
+
+		float py = y + 0.5f;
+		auto coverage = [&](int x, std::uint8_t *cov, int n) {
+			calc_box_coverage(circle, x, py, cov, n);
+			for (int i = 0; i < n; ++i) {
+				float px = x + i + 0.5f;
+				if (!is_in_sector(px - circle.cx, py - circle.cy))
+					cov[i] = 0;
+			}
+		};
+
+		paint_span_coverage(s, y, span->x0, span->x1, color, coverage);
+	}
+}
+
+void raster_ring(
+	const Surface &s, Point center, float inner_rad, float outer_rad,
+	RGBA color
+)
+{
+	if (outer_rad <= 0)
+		return;
+
+	auto outer = make_circle(center, outer_rad);
+	auto inner = make_circle(center, std::max(inner_rad, 0.f));
+
+	auto [y0, y1] = find_box_rows(s, outer);
+	for (int y = y0; y < y1; ++y) {
+		auto span = find_box_span(outer, y);
+		if (!span)
+			continue;
+
+		// Coverage of the outer circle minus that of the inner one.
+		float py = y + 0.5f;
+		auto coverage = [&](int x, std::uint8_t *cov, int n) {
+			std::uint8_t hole[COVERAGE_CHUNK];
+			calc_box_coverage(outer, x, py, cov, n);
+			calc_box_coverage(inner, x, py, hole, n);
+			for (int i = 0; i < n; ++i)
+				cov[i] = std::min<std::uint8_t>(cov[i], 255 - hole[i]);
+		};
+
+		// Pixels fully inside of the inner circle are not covered at all.
+		auto hole = inner.r > 0 ? find_box_span(inner, y) : std::nullopt;
+		if (!hole || hole->solid_x0 == hole->solid_x1) {
+			paint_span_coverage(s, y, span->x0, span->x1, color, coverage);
+			continue;
+		}
+
+		paint_span_coverage(s, y, span->x0, hole->solid_x0, color, coverage);
+		paint_span_coverage(s, y, hole->solid_x1, span->x1, color, coverage);
+	}
+}
+
+void raster_triangle(const Surface &s, Point v1, Point v2, Point v3, RGBA color)
+{
+	// Twice the signed area of the triangle (a, b, p), positive if p lies to
+	// the right of the edge from a to b.
+	auto edge = [](Point a, Point b, float px, float py) {
+		return (b.x - a.x) * (py - a.y) - (b.y - a.y) * (px - a.x);
+	};
+
+	float area = edge(v1, v2, v3.x, v3.y);
+	if (area == 0)
+		return;
+	if (area < 0)
+		std::swap(v2, v3);
+
+	auto lo = max_components(
+		min_components(min_components(v1, v2), v3), s.clip_lo
+	);
+	auto hi = min_components(
+		max_components(max_components(v1, v2), v3), s.clip_hi
+	);
+
+	for (int y = lo.y; y < hi.y; ++y) {
+		float py = y + 0.5f;
+
+		// Triangles are convex, so the covered pixels of a row are together.
+		int first = hi.x;
+		int last = lo.x - 1;
+		for (int x = lo.x; x < hi.x; ++x) {
+			float px = x + 0.5f;
+			if (edge(v1, v2, px, py) >= 0 && edge(v2, v3, px, py) >= 0
+				&& edge(v3, v1, px, py) >= 0) {
+				first = std::min(first, x);
+				last = x;
+			}
+		}
+
+		paint_span(s, y, first, last + 1, color);
+	}
+}
+
+void raster_image(const Surface &s, Point pos, const RGBA *src, Point src_size)
+{
+	int x0 = std::max(pos.x, s.clip_lo.x);
+	int x1 = std::min(pos.x + src_size.x, s.clip_hi.x);
+	int y0 = std::max(pos.y, s.clip_lo.y);
+	int y1 = std::min(pos.y + src_size.y, s.clip_hi.y);
+	if (x0 >= x1)
+		return;
+
+	for (int y = y0; y < y1; ++y) {
+		auto row = src + static_cast<std::ptrdiff_t>(y - pos.y) * src_size.x;
+		blend_span_pixels(pixel_at(s, x0, y), row + (x0 - pos.x), x1 - x0);
+	}
+}
+} // namespace eggui
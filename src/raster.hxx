@@ -0,0 +1,79 @@
+/// CPU rasterization of primitive shapes into RGBA pixel buffers.
+/// Colors are blended source-over and edges of round shapes are anti-aliased
+/// by the area of each pixel they cover.
+
+#ifndef RASTER_HXX_INCLUDED
+#define RASTER_HXX_INCLUDED
+
+#include <cstdint>
+
+#include "point.hxx"
+#include "graphics.hxx"
+
+namespace eggui
+{
+/// @brief Pixels drawn onto, along with the area drawing is restricted to.
+struct Surface {
+	// Rows of pixels stored one after another.
+	RGBA *pixels;
+	Point size;
+	// Clip area from `clip_lo` to `clip_hi`(exclusive), inside of the surface.
+	Point clip_lo;
+	Point clip_hi;
+};
+
+// Span kernels
+// A span is a run of pixels in a row, all of them get the same color.
+// Kernels are vectorized with SSE2 or AVX2 when the compiler targets them,
+// with a scalar fallback.
+//---------------------------------------------------------
+/// @brief Choose between the vectorized and the scalar kernels, vectorized
+///        ones are used by default. Both give the same results.
+void set_simd_enabled(bool enable);
+/// @brief Get the instruction set used by the kernels.
+/// @return nullptr if the scalar kernels are used.
+const char *get_simd_name();
+
+/// @brief Draw the color over the pixels.
+void blend_span(RGBA *dst, int n, RGBA color);
+/// @brief Draw the color over the pixels, scaling its alpha by coverage.
+/// @param coverage Coverage of each pixel, 0 to 255.
+void blend_span_coverage(
+	RGBA *dst, const std::uint8_t *coverage, int n, RGBA color
+);
+/// @brief Draw the source pixels over the destination pixels.
+void blend_span_pixels(RGBA *dst, const RGBA *src, int n);
+
+// Shapes
+// Positions are in pixels, where pixel (x, y) covers the area from (x, y)
+// to (x + 1, y + 1).
+//---------------------------------------------------------
+void raster_pixel(const Surface &s, Point pos, RGBA color);
+/// @brief Draw a one pixel wide line, both ends included.
+void raster_line(const Surface &s, Point start, Point end, RGBA color);
+void raster_rect(const Surface &s, Point pos, Point size, RGBA color);
+void raster_rect_lines(const Surface &s, Point pos, Point size, RGBA color);
+/// @param radius Corner radius, at most half of the smaller side.
+void raster_rounded_rect(
+	const Surface &s, Point pos, Point size, float radius, RGBA color
+);
+void raster_circle(const Surface &s, Point center, float radius, RGBA color);
+/// @brief Draw part of a circle between the angles, in degrees, clockwise
+///        from the positive x-axis.
+void raster_circle_sector(
+	const Surface &s, Point center, float radius, float start_angle,
+	float end_angle, RGBA color
+);
+void raster_ring(
+	const Surface &s, Point center, float inner_rad, float outer_rad,
+	RGBA color
+);
+/// @brief Draw a triangle, vertices may be in either order.
+void raster_triangle(const Surface &s, Point v1, Point v2, Point v3, RGBA color);
+/// @brief Draw the source pixels with their top-left corner at the position.
+void raster_image(
+	const Surface &s, Point pos, const RGBA *src, Point src_size
+);
+} // namespace eggui
+
+#endif
@@ -0,0 +1,350 @@
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+#include "raylib/raylib.h"
+
+#include "roboto_mono.bin.h"
+#include "backend.hxx"
+#include "constants.hxx"
+
+// Raylib has GLFW built in, but does not wrap waking it from another thread.
+extern "C" void glfwPostEmptyEvent(void);
+
+using namespace eggui;
+
+// Conversion and functions
+//---------------------------------------------------------
+constexpr inline Color to_color(RGBA rgba)
+{
+	return Color{rgba.r, rgba.g, rgba.b, rgba.a};
+}
+
+constexpr inline Vector2 to_vec2(Point point)
+{
+	return Vector2{static_cast<float>(point.x), static_cast<float>(point.y)};
+}
+
+inline Point vec2_to_point(Vector2 v) { return Point(v.x, v.y); }
+
+inline Rectangle points_to_rect(Point pos, Point size)
+{
+	Rectangle ret;
+	ret.x = pos.x;
+	ret.y = pos.y;
+	ret.width = size.x;
+	ret.height = size.y;
+
+	return ret;
+}
+
+// Calculation & transformation functions
+//---------------------------------------------------------
+inline int calc_segments(float radius, float angle = 360.0)
+{
+	angle = std::abs(angle);
+	// Too many segments value causes artifacts at corners when AA4X is enabled.
+	if (radius < 5.)
+		return 10. * angle / 360;
+	return radius * 1.5 * angle / 360;
+}
+
+inline int get_index_for_font_size(eggui::FontSize font_size)
+{
+	return static_cast<int>(font_size);
+}
+
+inline int to_mouse_cursor(CursorShape shape)
+{
+	using enum CursorShape;
+	switch (shape) {
+	case Default:
+		return MOUSE_CURSOR_DEFAULT;
+	case Arrow:
+		return MOUSE_CURSOR_ARROW;
+	case IBeam:
+		return MOUSE_CURSOR_IBEAM;
+	case Cross:
+		return MOUSE_CURSOR_CROSSHAIR;
+	case Hand:
+		return MOUSE_CURSOR_POINTING_HAND;
+	case ResizeEW:
+		return MOUSE_CURSOR_RESIZE_EW;
+	case ResizeNS:
+		return MOUSE_CURSOR_RESIZE_NS;
+	case ResizeNWSE:
+		return MOUSE_CURSOR_RESIZE_NWSE;
+	case ResizeNESW:
+		return MOUSE_CURSOR_RESIZE_NESW;
+	case ResizeOmni:
+		return MOUSE_CURSOR_RESIZE_ALL;
+	case Disallowed:
+		return MOUSE_CURSOR_NOT_ALLOWED;
+	}
+
+	return MOUSE_CURSOR_DEFAULT;
+}
+
+// Raylib backend
+//---------------------------------------------------------
+/// @brief Draws using raylib(OpenGL) onto a desktop window.
+class RaylibBackend final : public Backend
+{
+public:
+	void open_window(Point size, const char *title) override;
+	void close_window() override { CloseWindow(); }
+	bool is_window_open() const override { return IsWindowReady(); }
+	bool should_close() override { return WindowShouldClose(); }
+	bool is_resized() override { return IsWindowResized(); }
+
+	Point get_window_size() override
+	{
+		return Point(GetScreenWidth(), GetScreenHeight());
+	}
+	Point get_monitor_size() override
+	{
+		auto monitor = GetCurrentMonitor();
+		return Point(GetMonitorWidth(monitor), GetMonitorHeight(monitor));
+	}
+	void set_title(const char *title) override { SetWindowTitle(title); }
+	void set_size_limits(Point min_size, Point max_size) override
+	{
+		SetWindowMinSize(min_size.x, min_size.y);
+		SetWindowMaxSize(max_size.x, max_size.y);
+	}
+	void set_cursor_shape(CursorShape shape) override
+	{
+		SetMouseCursor(to_mouse_cursor(shape));
+	}
+
+	double get_time() override { return GetTime(); }
+	void wait_time(double seconds) override { WaitTime(seconds); }
+	void set_event_waiting(bool enable) override
+	{
+		if (enable)
+			EnableEventWaiting();
+		else
+			DisableEventWaiting();
+	}
+	void poll_events() override { PollInputEvents(); }
+	void wake() override
+	{
+		if (IsWindowReady())
+			glfwPostEmptyEvent();
+	}
+
+	Point get_mouse_position() override
+	{
+		return vec2_to_point(GetMousePosition());
+	}
+	Point get_mouse_delta() override { return vec2_to_point(GetMouseDelta()); }
+	Point get_mouse_wheel() override
+	{
+		return vec2_to_point(GetMouseWheelMoveV());
+	}
+	bool is_mouse_pressed() override
+	{
+		return IsMouseButtonPressed(MOUSE_BUTTON_LEFT);
+	}
+	bool is_mouse_released() override
+	{
+		return IsMouseButtonReleased(MOUSE_BUTTON_LEFT);
+	}
+	// Our keycodes are same as those of raylib.
+	bool is_key_pressed(Key key) override
+	{
+		return IsKeyPressed(static_cast<int>(key));
+	}
+	Key get_key_pressed() override { return static_cast<Key>(GetKeyPressed()); }
+	int get_char_pressed() override { return GetCharPressed(); }
+
+	void load_fonts() override;
+	void unload_fonts() override;
+	Point measure_text(const char *text, FontSize font_size) override;
+	float measure_glyph(int codepoint, FontSize font_size) override;
+
+	void begin_frame() override { BeginDrawing(); }
+	void end_frame() override { EndDrawing(); }
+
+	void clear(RGBA color) override { ClearBackground(to_color(color)); }
+	void set_clip(std::optional<std::pair<Point, Point>> area) override;
+	void draw(const DrawCommand &cmd, const char *text) override;
+
+	int create_target(Point size) override;
+	void destroy_target(int id) override;
+	void set_target(int id) override;
+
+private:
+	/// Font glyphs need to be rendered for each font size, indexed by FontSize.
+	Font mono_fonts[FONT_SIZE_COUNT]{};
+	/// Render targets indexed by id - 1, freed targets have zero id.
+	std::vector<RenderTexture2D> targets;
+	/// Target being drawn onto, 0 for the window.
+	int current_target = 0;
+};
+
+void RaylibBackend::open_window(Point size, const char *title)
+{
+	SetTraceLogLevel(LOG_WARNING);
+	SetConfigFlags(FLAG_WINDOW_RESIZABLE | FLAG_VSYNC_HINT | FLAG_MSAA_4X_HINT);
+	InitWindow(size.x, size.y, title);
+
+	// This is not really needed since we also check for frame timing manually,
+	// but just in case the default FPS is too low and it sleeps for too long.
+	if (!IsWindowState(FLAG_VSYNC_HINT))
+		SetTargetFPS(TICKS_PER_SECOND);
+
+	SetExitKey(KEY_NULL); // Do not exit on ESC.
+}
+
+void RaylibBackend::load_fonts()
+{
+	for (int i = 0; i < FONT_SIZE_COUNT; ++i) {
+		mono_fonts[i] = LoadFontFromMemory(
+			".ttf", ROBOTO_MONO_TTF, ROBOTO_MONO_TTF_LEN, FONT_PX_SIZES[i],
+			nullptr, 0
+		);
+	}
+}
+
+void RaylibBackend::unload_fonts()
+{
+	for (auto &font : mono_fonts)
+		UnloadFont(font);
+}
+
+Point RaylibBackend::measure_text(const char *text, FontSize font_size)
+{
+	int idx = get_index_for_font_size(font_size);
+	auto sz = MeasureTextEx(mono_fonts[idx], text, FONT_PX_SIZES[idx], 0);
+	return Point(sz.x, sz.y);
+}
+
+float RaylibBackend::measure_glyph(int codepoint, FontSize font_size)
+{
+	// Same as how MeasureTextEx measures each glyph.
+	int idx = get_index_for_font_size(font_size);
+	auto &font = mono_fonts[idx];
+	int glyph = GetGlyphIndex(font, codepoint);
+	float scale = float(FONT_PX_SIZES[idx]) / font.baseSize;
+
+	if (font.glyphs[glyph].advanceX != 0)
+		return font.glyphs[glyph].advanceX * scale;
+	return font.recs[glyph].width * scale;
+}
+
+void RaylibBackend::set_clip(std::optional<std::pair<Point, Point>> area)
+{
+	if (area) {
+		auto [pos, sz] = *area;
+		BeginScissorMode(pos.x, pos.y, sz.x, sz.y);
+	} else {
+		EndScissorMode();
+	}
+}
+
+void RaylibBackend::draw(const DrawCommand &cmd, const char *text)
+{
+	auto [p0, p1, p2] = cmd.points;
+	auto [f0, f1, f2] = cmd.params;
+	auto color = to_color(cmd.color);
+
+	switch (cmd.op) {
+	case DrawOp::Pixel:
+		DrawPixel(p0.x, p0.y, color);
+		break;
+	case DrawOp::Line:
+		DrawLine(p0.x, p0.y, p1.x, p1.y, color);
+		break;
+	case DrawOp::Rect:
+		DrawRectangle(p0.x, p0.y, p1.x, p1.y, color);
+		break;
+	case DrawOp::RectLines:
+		DrawRectangleLines(p0.x, p0.y, p1.x, p1.y, color);
+		break;
+	case DrawOp::RoundedRect: {
+		auto segs = calc_segments(std::min(p1.x, p1.y) / 2. * f0);
+		DrawRectangleRounded(points_to_rect(p0, p1), f0, segs, color);
+		break;
+	}
+	case DrawOp::Circle:
+		DrawCircle(p0.x, p0.y, f0, color);
+		break;
+	case DrawOp::CircleSector: {
+		int segs = calc_segments(f0, f2 - f1);
+		DrawCircleSector(to_vec2(p0), f0, f1, f2, segs, color);
+		break;
+	}
+	case DrawOp::Ring:
+		DrawRing(to_vec2(p0), f0, f1, 0, 360., calc_segments(f1), color);
+		break;
+	case DrawOp::Triangle:
+		DrawTriangle(to_vec2(p0), to_vec2(p1), to_vec2(p2), color);
+		break;
+	case DrawOp::Text: {
+		int idx = get_index_for_font_size(cmd.font_size);
+		DrawTextEx(
+			mono_fonts[idx], text, to_vec2(p0), FONT_PX_SIZES[idx], f0, color
+		);
+		break;
+	}
+	case DrawOp::RenderTarget: {
+		// Render textures are stored upside down.
+		auto &tex = targets[cmd.target - 1].texture;
+		Rectangle src{0, 0, float(tex.width), -float(tex.height)};
+		DrawTextureRec(tex, src, to_vec2(p0), color);
+		break;
+	}
+	case DrawOp::Subdraw:
+		assert(!"Sub-draws are drawn by the caller.");
+		break;
+	}
+}
+
+int RaylibBackend::create_target(Point size)
+{
+	auto target = LoadRenderTexture(size.x, size.y);
+	if (target.id == 0)
+		return 0;
+
+	// Reuse slot of a freed target if any.
+	auto slot = std::ranges::find_if(targets, [](auto &t) {
+		return t.id == 0;
+	});
+	if (slot == targets.end()) {
+		targets.push_back(target);
+		return targets.size();
+	}
+
+	*slot = target;
+	return slot - targets.begin() + 1;
+}
+
+void RaylibBackend::destroy_target(int id)
+{
+	assert(id > 0 && id <= int(targets.size()));
+	assert(id != current_target);
+
+	UnloadRenderTexture(targets[id - 1]);
+	targets[id - 1] = RenderTexture2D{};
+}
+
+void RaylibBackend::set_target(int id)
+{
+	// Texture modes do not nest, so end the current one first.
+	if (current_target)
+		EndTextureMode();
+	if (id)
+		BeginTextureMode(targets[id - 1]);
+
+	current_target = id;
+}
+
+namespace eggui
+{
+std::unique_ptr<Backend> make_raylib_backend()
+{
+	return std::make_unique<RaylibBackend>();
+}
+} // namespace eggui
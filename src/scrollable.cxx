@@ -194,6 +194,7 @@ void ScrollBar::set_scroll_fraction(float frac)
 	slider.set_position(offsets[scroll_axis]);
 
 	scroll_fraction = frac;
+	mark_damaged();
 	on_scroll(scroll_fraction);
 }
 
@@ -222,6 +223,7 @@ VScrollView::VScrollView(int w, int h, std::shared_ptr<Widget> child_)
 
 		pos[AXIS] = calc_container_pos(view_len, cont_len, frac);
 		child->set_position(pos);
+		mark_damaged();
 	});
 }
 
@@ -243,6 +245,12 @@ void VScrollView::layout_children(Point size_hint)
 		get_size()[AXIS], size_hint[AXIS], child_size[AXIS],
 		child->get_position()[AXIS]
 	);
+	// The child may have shrunk, do not leave space after its end.
+	child_pos = std::max(child_pos, std::min(0, size_hint[AXIS] - child_size[AXIS]));
+
+	// Resize first, children placing their content by what is visible in the
+	// view see the new size.
+	Widget::set_size(size_hint);
 
 	child->set_size(child_size);
 	if (AXIS == ScrollBar::Axis::X)
@@ -251,7 +259,7 @@ void VScrollView::layout_children(Point size_hint)
 		child->set_ypos(child_pos);
 
 	auto frac = calc_scroll_frac(
-		get_size()[AXIS], child->get_size()[AXIS], child->get_position()[AXIS]
+		size_hint[AXIS], child->get_size()[AXIS], child->get_position()[AXIS]
 	);
 	scrollbar->set_scroll_fraction(frac);
 	scrollbar->set_size(Point(SCROLL_BAR_WIDTH, size_hint.y));
@@ -262,8 +270,6 @@ void VScrollView::layout_children(Point size_hint)
 	// slide length to decrease its scroll space and vice-versa.
 	auto len = calc_slider_len(size_hint[AXIS], child->get_size()[AXIS]);
 	scrollbar->set_slider_len(len);
-
-	Widget::set_size(size_hint);
 }
 
 Point VScrollView::calc_layout_info()
@@ -288,6 +294,71 @@ Point VScrollView::calc_layout_info()
 	return get_min_size();
 }
 
+void VScrollView::scroll_into_view(int start, int len)
+{
+	int view_len = get_size()[AXIS];
+	int cont_len = child->get_size()[AXIS];
+	int pos = child->get_position()[AXIS];
+	if (cont_len <= view_len)
+		return;
+
+	if (start + pos < 0)
+		pos = -start;
+	else if (start + len + pos > view_len)
+		pos = view_len - start - len;
+	else
+		return;
+
+	pos = std::clamp(pos, view_len - cont_len, 0);
+	scrollbar->set_scroll_fraction(calc_scroll_frac(view_len, cont_len, pos));
+}
+
+int VScrollView::calc_rows_height(long long row_count, int row_height)
+{
+	// Scroll fractions are floats, so scrolling can not be more precise than
+	// a pixel beyond this.
+	constexpr long long MAX_HEIGHT = 1 << 24;
+	return std::min(MAX_HEIGHT, row_count * row_height);
+}
+
+std::pair<int, int> VScrollView::calc_shown_span(const Widget &w)
+{
+	int top = 0;
+	int view_len = w.get_size().y;
+	if (auto view = dynamic_cast<VScrollView *>(w.get_parent())) {
+		top = std::max(0, -w.get_position().y);
+		view_len = std::min(view_len, view->get_size().y);
+	}
+
+	return std::pair(top, view_len);
+}
+
+double VScrollView::calc_first_row(
+	int top, int view_len, int height, long row_count, int row_height
+)
+{
+	// The first row is at the top when scrolled to the start, and the last
+	// row at the bottom when scrolled to the end.
+	double scroll_len = height - view_len;
+	double scroll_rows = std::max(
+		0., row_count - double(view_len) / row_height
+	);
+	return scroll_len > 0 ? top * scroll_rows / scroll_len : 0;
+}
+
+double VScrollView::calc_row_top(
+	double place, int view_len, int height, long row_count, int row_height
+)
+{
+	double scroll_len = std::max(0, height - view_len);
+	double scroll_rows = std::max(
+		0., row_count - double(view_len) / row_height
+	);
+	if (scroll_rows == 0)
+		return 0;
+	return std::clamp(place * scroll_len / scroll_rows, 0., scroll_len);
+}
+
 Widget *VScrollView::notify(Event ev)
 {
 	// Find the innermost scrollable widget, if none exists then,
@@ -0,0 +1,238 @@
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+
+#include "software_backend.hxx"
+#include "raster.hxx"
+
+using namespace eggui;
+
+/// @brief Horizontal advance of each glyph, like Roboto Mono which is
+///        0.6 times as wide as the font size.
+inline int calc_glyph_advance(FontSize font_size)
+{
+	return (font_size_to_pixels(font_size) * 3 + 2) / 5;
+}
+
+/// @brief Check if the byte starts a UTF-8 encoded character.
+inline bool is_char_start(char c) { return (c & 0xC0) != 0x80; }
+
+// Framebuffer access
+//---------------------------------------------------------
+RGBA SoftwareBackend::get_pixel(Point pos) const
+{
+	assert(pos.is_in_box(Point(0, 0), window.size));
+	return window.pixels[pos.y * window.size.x + pos.x];
+}
+
+void SoftwareBackend::set_simd_enabled(bool enable)
+{
+	eggui::set_simd_enabled(enable);
+}
+
+const char *SoftwareBackend::get_simd_name() { return eggui::get_simd_name(); }
+
+SoftwareBackend::Framebuffer &SoftwareBackend::get_framebuffer()
+{
+	return current_target ? targets[current_target - 1] : window;
+}
+
+void SoftwareBackend::resize_framebuffer(Framebuffer &fb, Point size)
+{
+	fb.size = size;
+	fb.pixels.assign(static_cast<std::size_t>(size.x) * size.y, RGBA(0, 0, 0));
+}
+
+// Window management
+//---------------------------------------------------------
+void SoftwareBackend::open_window(Point size, const char *)
+{
+	assert(!is_open);
+
+	resize_framebuffer(window, clamp_components(size, Point(1, 1), monitor_size));
+	is_open = true;
+	close_requested = false;
+}
+
+void SoftwareBackend::set_size_limits(Point min_size, Point max_size)
+{
+	min_window_size = min_size;
+	max_window_size = max_size;
+}
+
+// Time and events
+//---------------------------------------------------------
+void SoftwareBackend::poll_events()
+{
+	if (poll_callback)
+		poll_callback(*this);
+
+	// Mouse position persists, everything else is seen only once.
+	auto mouse_pos = pending.mouse_pos;
+	mouse_delta = mouse_pos - current.mouse_pos;
+	current = std::exchange(pending, Input{});
+	pending.mouse_pos = mouse_pos;
+	keys_taken = 0;
+	chars_taken = 0;
+
+	resized = false;
+	if (auto size = current.window_size) {
+		*size = clamp_components(*size, min_window_size, max_window_size);
+		*size = clamp_components(*size, Point(1, 1), monitor_size);
+		if (*size != window.size) {
+			resize_framebuffer(window, *size);
+			resized = true;
+		}
+	}
+}
+
+bool SoftwareBackend::is_key_pressed(Key key)
+{
+	return std::ranges::find(current.keys, key) != current.keys.end();
+}
+
+Key SoftwareBackend::get_key_pressed()
+{
+	if (keys_taken == current.keys.size())
+		return Key::Null;
+	return current.keys[keys_taken++];
+}
+
+int SoftwareBackend::get_char_pressed()
+{
+	if (chars_taken == current.chars.size())
+		return 0;
+	return current.chars[chars_taken++];
+}
+
+// Drawing
+//---------------------------------------------------------
+Point SoftwareBackend::measure_text(const char *text, FontSize font_size)
+{
+	int len = std::count_if(text, text + std::strlen(text), is_char_start);
+	return Point(len * calc_glyph_advance(font_size), font_size_to_pixels(font_size));
+}
+
+float SoftwareBackend::measure_glyph(int, FontSize font_size)
+{
+	return calc_glyph_advance(font_size);
+}
+
+void SoftwareBackend::end_frame()
+{
+	frame_count++;
+	poll_events();
+}
+
+void SoftwareBackend::clear(RGBA color)
+{
+	auto &fb = get_framebuffer();
+	std::ranges::fill(fb.pixels, color);
+}
+
+void SoftwareBackend::draw(const DrawCommand &cmd, const char *text)
+{
+	auto &fb = get_framebuffer();
+
+	Surface s{
+		.pixels = fb.pixels.data(),
+		.size = fb.size,
+		.clip_lo = Point(0, 0),
+		.clip_hi = fb.size,
+	};
+	if (clip_area) {
+		auto [pos, size] = *clip_area;
+		s.clip_lo = clamp_components(pos, Point(0, 0), fb.size);
+		s.clip_hi = clamp_components(pos + size, s.clip_lo, fb.size);
+	}
+
+	auto [p0, p1, p2] = cmd.points;
+	auto [f0, f1, f2] = cmd.params;
+
+	switch (cmd.op) {
+	case DrawOp::Pixel:
+		raster_pixel(s, p0, cmd.color);
+		break;
+	case DrawOp::Line:
+		raster_line(s, p0, p1, cmd.color);
+		break;
+	case DrawOp::Rect:
+		raster_rect(s, p0, p1, cmd.color);
+		break;
+	case DrawOp::RectLines:
+		raster_rect_lines(s, p0, p1, cmd.color);
+		break;
+	case DrawOp::RoundedRect: {
+		// Roundness is relative to the shorter side, like for raylib.
+		float radius = std::clamp(f0, 0.f, 1.f) * std::min(p1.x, p1.y) / 2;
+		raster_rounded_rect(s, p0, p1, radius, cmd.color);
+		break;
+	}
+	case DrawOp::Circle:
+		raster_circle(s, p0, f0, cmd.color);
+		break;
+	case DrawOp::CircleSector:
+		raster_circle_sector(s, p0, f0, f1, f2, cmd.color);
+		break;
+	case DrawOp::Ring:
+		raster_ring(s, p0, f0, f1, cmd.color);
+		break;
+	case DrawOp::Triangle:
+		raster_triangle(s, p0, p1, p2, cmd.color);
+		break;
+	case DrawOp::Text: {
+		// Glyphs are boxes covering the middle of their cells.
+		int px = font_size_to_pixels(cmd.font_size);
+		int advance = calc_glyph_advance(cmd.font_size);
+		Point glyph_size(advance - 2 * (advance / 6), px / 2);
+		Point glyph_pos = p0 + Point(advance / 6, px / 3);
+
+		for (auto c = text; *c; ++c) {
+			if (!is_char_start(*c))
+				continue;
+			if (*c != ' ')
+				raster_rect(s, glyph_pos, glyph_size, cmd.color);
+			glyph_pos.x += advance + f0;
+		}
+		break;
+	}
+	case DrawOp::RenderTarget: {
+		auto &target = targets[cmd.target - 1];
+		raster_image(s, p0, target.pixels.data(), target.size);
+		break;
+	}
+	case DrawOp::Subdraw:
+		assert(!"Sub-draws are drawn by the caller.");
+		break;
+	}
+}
+
+// Offscreen targets
+//---------------------------------------------------------
+int SoftwareBackend::create_target(Point size)
+{
+	// Reuse slot of a freed target if any.
+	auto slot = std::ranges::find_if(targets, [](auto &t) {
+		return t.size == Point(0, 0);
+	});
+	if (slot == targets.end())
+		slot = targets.insert(slot, Framebuffer{});
+
+	resize_framebuffer(*slot, size);
+	return slot - targets.begin() + 1;
+}
+
+void SoftwareBackend::destroy_target(int id)
+{
+	assert(id > 0 && id <= int(targets.size()));
+	assert(id != current_target);
+
+	targets[id - 1] = Framebuffer{};
+}
+
+void SoftwareBackend::set_target(int id)
+{
+	assert(id >= 0 && id <= int(targets.size()));
+	current_target = id;
+}
@@ -0,0 +1,341 @@
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <ranges>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "widget.hxx"
+#include "window.hxx"
+#include "scrollable.hxx"
+#include "table.hxx"
+#include "theme.hxx"
+#include "graphics.hxx"
+#include "managers.hxx"
+#include "calc.hxx"
+#include "utils/parallel_sort.hxx"
+#include "utils/utf8.hxx"
+
+using namespace eggui;
+
+/// Tables with at least this many rows are sorted off the UI thread.
+constexpr int PARALLEL_SORT_ROWS = 100'000;
+/// Rows measured to fit the width of columns to their cells.
+constexpr int FIT_ROWS = 1000;
+
+/// @brief Cut the text short so that it fits the width.
+static void fit_text(std::string &str, int width, FontSize font_size)
+{
+	float xpos = 0;
+	for (std::size_t i = 0; i < str.size();) {
+		auto start = i;
+		xpos += tell_glyph_advance(decode_utf8(str, i), font_size);
+		if (xpos > width) {
+			str.resize(start);
+			return;
+		}
+	}
+}
+
+/// @brief Make a comparison of rows by their cells in the column. Ties are
+///        broken by the row index, so that sorts are stable.
+static std::function<bool(int, int)> make_row_less(
+	const TableSource &source, int col, bool ascending
+)
+{
+	auto less = source.less;
+	if (!less) {
+		less = [get_cell = source.get_cell](int c, int a, int b) {
+			return get_cell(a, c) < get_cell(b, c);
+		};
+	}
+
+	return [less, col, ascending](int a, int b) {
+		if (ascending ? less(col, a, b) : less(col, b, a))
+			return true;
+		if (ascending ? less(col, b, a) : less(col, a, b))
+			return false;
+		return a < b;
+	};
+}
+
+// Table members
+//---------------------------------------------------------
+struct Table::Sorter {
+	// Give up the sort instead of waiting for it, the rows may change or be
+	// gone once the sorter is.
+	~Sorter()
+	{
+		stop.store(true, std::memory_order_relaxed);
+		if (thread.joinable())
+			thread.join();
+	}
+
+	std::thread thread;
+	std::atomic<bool> is_done = false;
+	std::atomic<bool> stop = false;
+
+	// Sort being done.
+	int column;
+	bool ascending;
+	// Rows in their sorted order, taken once done.
+	std::vector<int> order;
+};
+
+Table::Table(
+	int w, int h, std::vector<TableColumn> columns_, TableSource source_,
+	FontSize font_size_
+)
+	: Interactive(w, h)
+	, columns(std::move(columns_))
+	, source(std::move(source_))
+	, base_size(w, h)
+	, font_size(font_size_)
+{
+	assert(source.get_row_count && source.get_cell);
+	refresh();
+}
+
+Table::~Table() { TickManager::instance().remove(this); }
+
+void Table::refresh()
+{
+	// The rows may change now, stop any sort reading them.
+	TickManager::instance().remove(this);
+	sorter.reset();
+
+	// Rows stay in their last order until sorted again, unless some are
+	// gone or new.
+	row_count = std::max(0, source.get_row_count());
+	if (int(order.size()) != row_count) {
+		order.resize(row_count);
+		std::iota(order.begin(), order.end(), 0);
+	}
+
+	fit_columns();
+	fit_rows();
+	start_sort();
+	mark_damaged();
+}
+
+void Table::sort_by(int col, bool ascending)
+{
+	assert(-1 <= col && col < int(columns.size()));
+
+	sort_column = col;
+	sort_ascending = ascending;
+	start_sort();
+	mark_damaged();
+}
+
+bool Table::is_sorting() const { return sorter != nullptr; }
+
+int Table::get_row_at(int place) const
+{
+	assert(0 <= place && place < row_count);
+	return order[place];
+}
+
+int Table::find_place(Point pos) const
+{
+	auto [top, view_len] = VScrollView::calc_shown_span(*this);
+	int rh = get_row_height();
+	if (pos.y < top + rh)
+		return -1;
+
+	double first = calc_first_place(top, view_len);
+	long place = std::floor(first + double(pos.y - top - rh) / rh);
+	return place < row_count ? place : -1;
+}
+
+void Table::start_sort()
+{
+	// The running sort is taken once done, and the sort asked for started.
+	if (sorter)
+		return;
+
+	if (sort_column < 0) {
+		std::iota(order.begin(), order.end(), 0);
+		return;
+	}
+
+	auto less = make_row_less(source, sort_column, sort_ascending);
+	if (row_count < PARALLEL_SORT_ROWS) {
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), less);
+		return;
+	}
+
+	sorter = std::make_unique<Sorter>();
+	sorter->column = sort_column;
+	sorter->ascending = sort_ascending;
+	sorter->thread = std::thread([s = sorter.get(), less, count = row_count]() {
+		s->order.resize(count);
+		std::iota(s->order.begin(), s->order.end(), 0);
+		bool is_sorted = parallel_sort(
+			s->order.begin(), s->order.end(), less,
+			std::thread::hardware_concurrency(), s->stop
+		);
+		s->is_done.store(is_sorted, std::memory_order_release);
+	});
+	TickManager::instance().add(this, [this]() { return take_order(); });
+}
+
+bool Table::take_order()
+{
+	if (!sorter->is_done.load(std::memory_order_acquire))
+		return true;
+
+	// The sort asked for may have changed meanwhile.
+	bool is_wanted = sorter->column == sort_column
+					 && sorter->ascending == sort_ascending;
+	if (is_wanted)
+		order = std::move(sorter->order);
+	sorter.reset();
+
+	if (!is_wanted)
+		start_sort();
+	mark_damaged();
+	return false;
+}
+
+void Table::fit_columns()
+{
+	col_widths.resize(columns.size());
+
+	int rows = std::min(row_count, FIT_ROWS);
+	for (unsigned c = 0; c < columns.size(); ++c) {
+		if (columns[c].width > 0) {
+			col_widths[c] = columns[c].width;
+			continue;
+		}
+
+		// Leave space for the sort marker after the title.
+		auto title = columns[c].title + " ^";
+		int width = tell_text_size(title.c_str(), font_size).x;
+		for (int r = 0; r < rows; ++r) {
+			auto cell = source.get_cell(r, c);
+			width = std::max(width, tell_text_size(cell.c_str(), font_size).x);
+		}
+		col_widths[c] = width + 2 * TEXT_PADDING;
+	}
+
+	content_width = calc_box_offsets(col_widths, 0, col_offsets);
+
+	// Columns past the width of the table could not be scrolled to.
+	int width = std::max(base_size.x, content_width);
+	if (width == get_min_size().x)
+		return;
+
+	set_min_size(Point(width, get_min_size().y));
+	set_max_size(Point(std::max(width, get_max_size().x), get_max_size().y));
+	set_size(Point(std::max(width, get_size().x), get_size().y));
+	invalidate_layout();
+}
+
+void Table::fit_rows()
+{
+	// One more row for the header.
+	int rh = get_row_height();
+	set_fixed_height(std::max(
+		base_size.y, VScrollView::calc_rows_height(row_count + 1, rh)
+	));
+}
+
+double Table::calc_first_place(int top, int view_len) const
+{
+	// Rows are placed by how far the table is scrolled, in the part of it
+	// below the header.
+	int rh = get_row_height();
+	return VScrollView::calc_first_row(
+		top, view_len - rh, get_size().y - rh, row_count, rh
+	);
+}
+
+int Table::get_row_height() const
+{
+	return font_size_to_pixels(font_size) + TEXT_PADDING;
+}
+
+Widget *Table::notify(Event ev)
+{
+	if (handle_mouse_hover_events(ev))
+		return this;
+	if (handle_mouse_press_events(ev))
+		return this;
+
+	if (ev.type != EventType::MouseClick)
+		return Interactive::notify(ev);
+
+	// Clicking a column title sorts by it, or reverses the order.
+	auto [top, view_len] = VScrollView::calc_shown_span(*this);
+	if (ev.cursor.y >= top + get_row_height())
+		return this;
+
+	auto cols = std::views::iota(0, int(columns.size()));
+	int col = std::ranges::partition_point(cols, [&](int c) {
+				  return col_offsets[c] + col_widths[c] <= ev.cursor.x;
+			  })
+			  - cols.begin();
+	if (col == int(columns.size()))
+		return this;
+
+	sort_by(col, col == sort_column ? !sort_ascending : true);
+	return this;
+}
+
+void Table::draw()
+{
+	auto [top, view_len] = VScrollView::calc_shown_span(*this);
+	auto [clip_pos, clip_size] = get_unclipped_region();
+	int rh = get_row_height();
+
+	// Only the columns overlapping the clip area are drawn.
+	auto cols = std::views::iota(0, int(columns.size()));
+	int first_col = std::ranges::partition_point(cols, [&](int c) {
+						return col_offsets[c] + col_widths[c] <= clip_pos.x;
+					})
+					- cols.begin();
+	int last_col = std::ranges::partition_point(cols, [&](int c) {
+					   return col_offsets[c] < clip_pos.x + clip_size.x;
+				   })
+				   - cols.begin();
+
+	std::string str;
+	auto draw_cell = [&](int c, double ypos) {
+		fit_text(str, col_widths[c] - 2 * TEXT_PADDING, font_size);
+		Point pos(col_offsets[c] + TEXT_PADDING, ypos + TEXT_PADDING / 2);
+		draw_text(pos, TEXT_COLOR, str.c_str(), font_size);
+	};
+
+	double first = calc_first_place(top, view_len);
+	long place = std::floor(first);
+	double ypos = top + rh - (first - place) * rh;
+	for (; place < row_count && ypos < top + view_len; ++place, ypos += rh) {
+		if (ypos + rh <= clip_pos.y || ypos >= clip_pos.y + clip_size.y)
+			continue;
+
+		for (int c = first_col; c < last_col; ++c) {
+			str = source.get_cell(order[place], c);
+			draw_cell(c, ypos);
+		}
+	}
+
+	// The header stays at the top of the view, over the rows scrolled past.
+	draw_rect(Point(0, top), Point(get_size().x, rh), BUTTON_COLOR);
+	for (int c = first_col; c < last_col; ++c) {
+		str = columns[c].title;
+		if (c == sort_column)
+			str += sort_ascending ? " ^" : " v";
+		draw_cell(c, top);
+
+		int end = col_offsets[c] + col_widths[c];
+		draw_line(Point(end, top), Point(end, top + rh), BORDER_COLOR);
+	}
+}
@@ -1,5 +1,6 @@
 #include <cassert>
 #include <algorithm>
+#include <ranges>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -16,8 +17,17 @@ inline int get_sign(int s) { return s != 0 ? s / std::abs(s) : 0; }
 
 static float get_char_width(char c, FontSize size)
 {
-	const char s[] = {c, 0};
-	return tell_text_size(s, size).x;
+	return tell_glyph_advance(static_cast<unsigned char>(c), size);
+}
+
+/// @brief Binary search for the first of [0, n) the predicate is false for.
+/// @param pred Predicate which is true for a prefix of [0, n).
+/// @return The index found, n if it is true for all of them.
+template <typename F>
+static int find_partition(int n, F pred)
+{
+	auto indices = std::views::iota(0, n);
+	return std::ranges::partition_point(indices, pred) - indices.begin();
 }
 
 EditableTextBox::EditableTextBox(
@@ -32,22 +42,31 @@ EditableTextBox::EditableTextBox(
 void EditableTextBox::set_font_size(FontSize size)
 {
 	font_size = size;
-	calc_cursor_offset();
+	calc_char_positions();
+	mark_damaged();
 }
 
 void EditableTextBox::set_cursor_opacity(float opacity)
 {
 	cursor_opacity = std::clamp(255. * opacity, 0., 255.);
+
+	auto [pos, size] = calc_cursor_rect();
+	mark_damaged(pos, size);
 }
 
 void EditableTextBox::set_text(std::string txt)
 {
-	text = std::move(txt);
+	text.assign(txt);
 	cursor_at = 0;
-	cursor_xpos = 0;
+	calc_char_positions();
+	mark_damaged();
 }
 
-std::string_view EditableTextBox::get_text() const { return text; }
+std::string_view EditableTextBox::get_text() const
+{
+	auto chars = text.data();
+	return std::string_view(chars.data(), chars.size());
+}
 
 int EditableTextBox::move_cursor(int delta)
 {
@@ -55,25 +74,31 @@ int EditableTextBox::move_cursor(int delta)
 		std::clamp(cursor_at + delta, 0, static_cast<int>(text.size()));
 	delta = new_pos - cursor_at;
 
-	// Update cursor x-position as we move the cursor over characters.
-	for (int i = 0; i < std::abs(delta); ++i) {
-		if (delta > 0) {
-			cursor_xpos += get_char_width(text[cursor_at + i], font_size);
-		} else {
-			cursor_xpos -= get_char_width(text[cursor_at - i - 1], font_size);
-		}
-	}
-
 	cursor_at = new_pos;
+	mark_damaged();
 	return delta;
 }
 
 void EditableTextBox::insert_before_cursor(char c)
 {
-	cursor_xpos += get_char_width(c, font_size);
-	text.insert(text.begin() + cursor_at, c);
+	insert_before_cursor(std::string_view(&c, 1));
+}
+
+void EditableTextBox::insert_before_cursor(std::string_view str)
+{
+	text.insert(cursor_at, str);
+
+	// Characters after the cursor move right by the width of those inserted.
+	double start = char_xpos[cursor_at];
+	double xpos = start;
+	char_xpos.move_gap(cursor_at + 1);
+	for (char c : str) {
+		xpos += get_char_width(c, font_size);
+		char_xpos.insert(++cursor_at, xpos);
+	}
+	char_xpos.shift(xpos - start);
 
-	cursor_at++;
+	mark_damaged();
 }
 
 void EditableTextBox::delete_before_cursor()
@@ -81,11 +106,8 @@ void EditableTextBox::delete_before_cursor()
 	if (cursor_at == 0)
 		return;
 
-	char c = text[cursor_at - 1];
-	cursor_xpos -= get_char_width(c, font_size);
-
-	text.erase(text.begin() + cursor_at - 1);
 	cursor_at--;
+	delete_after_cursor();
 }
 
 void EditableTextBox::delete_after_cursor()
@@ -93,7 +115,13 @@ void EditableTextBox::delete_after_cursor()
 	if (cursor_at == static_cast<int>(text.size()))
 		return;
 
-	text.erase(text.begin() + cursor_at);
+	double width = char_xpos[cursor_at + 1] - char_xpos[cursor_at];
+
+	text.erase(cursor_at);
+	char_xpos.erase(cursor_at + 1);
+	char_xpos.shift(-width);
+
+	mark_damaged();
 }
 
 Widget *EditableTextBox::notify(Event ev)
@@ -101,53 +129,67 @@ Widget *EditableTextBox::notify(Event ev)
 	if (ev.type != EventType::MousePressed)
 		return Interactive::notify(ev);
 
-	float xpos = 0;
-	for (unsigned i = 0; i < text.size(); ++i) {
-		float width = get_char_width(text[i], font_size);
-
-		// TODO Add support correct cursor position on scrolled text.
-		// Move the cursor to the left of char if clicked in left-half, and
-		// move the cursor to the right of the char if pressed in right-half.
-		if (xpos > ev.cursor.x) {
-			// Nothing...
-		} else if (ev.cursor.x < xpos + width / 2) {
-			move_cursor(i - cursor_at);
-			return this;
-		} else if (ev.cursor.x < xpos + width) {
-			move_cursor(i + 1 - cursor_at);
-			return this;
-		}
-
-		xpos += width;
-	}
-
-	move_cursor(text.size() - cursor_at);
+	move_cursor(find_cursor_at(ev.cursor.x - calc_x_offset()) - cursor_at);
 	return this;
 }
 
 void EditableTextBox::draw()
 {
-	// constexpr int DRAW_BUF_SIZE = 255;
-	// char draw_buf[DRAW_BUF_SIZE + 1]{};
-
-	// Scroll the text to the cursor position on overflow.
-	float x_offset = std::min(0.f, get_size().x - cursor_xpos - CURSOR_WIDTH);
-	draw_text(Point(x_offset, 0), TEXT_COLOR, text.c_str(), font_size);
+	// Only draw the characters which are at least partly visible.
+	double x_offset = calc_x_offset();
+	int len = text.size();
+	int first = find_partition(len, [&](int i) {
+		return get_char_xpos(i + 1) + x_offset <= 0;
+	});
+	int last = find_partition(len, [&](int i) {
+		return get_char_xpos(i) + x_offset < get_size().x;
+	});
+
+	if (first < last) {
+		std::string visible(last - first, '\0');
+		text.copy(first, visible.size(), visible.data());
+
+		Point pos(x_offset + get_char_xpos(first), 0);
+		draw_text(pos, TEXT_COLOR, visible.c_str(), font_size);
+	}
 
 	// Draw the cursor
 	auto ccol = CURSOR_COLOR;
 	ccol.a = cursor_opacity;
+	auto [pos, size] = calc_cursor_rect();
+	draw_rect(pos, size, ccol);
+}
+
+double EditableTextBox::calc_x_offset() const
+{
+	// Scroll the text to the cursor position on overflow.
+	return std::min(0., get_size().x - get_char_xpos(cursor_at) - CURSOR_WIDTH);
+}
+
+std::pair<Point, Point> EditableTextBox::calc_cursor_rect() const
+{
+	Point pos(calc_x_offset() + get_char_xpos(cursor_at), 0);
 	Point size(CURSOR_WIDTH, font_size_to_pixels(font_size));
-	draw_rect(Point(x_offset + cursor_xpos, 0), size, ccol);
+	return {pos, size};
 }
 
-void EditableTextBox::calc_cursor_offset()
+void EditableTextBox::calc_char_positions()
 {
 	assert(cursor_at >= 0 && static_cast<unsigned>(cursor_at) <= text.size());
 
-	float pos = 0;
-	for (int i = 0; i < cursor_at; ++i)
-		pos += get_char_width(text[i], font_size);
+	std::vector<double> positions(text.size() + 1);
+	for (unsigned i = 0; i < text.size(); ++i)
+		positions[i + 1] = positions[i] + get_char_width(text[i], font_size);
 
-	cursor_xpos = pos;
+	char_xpos.assign(positions, positions.back());
+}
+
+int EditableTextBox::find_cursor_at(double xpos) const
+{
+	// Move the cursor to the left of char if clicked in left-half, and
+	// move the cursor to the right of the char if pressed in right-half.
+	// The middles of characters are increasing too, so binary search them.
+	return find_partition(text.size(), [&](int i) {
+		return (get_char_xpos(i) + get_char_xpos(i + 1)) / 2 <= xpos;
+	});
 }
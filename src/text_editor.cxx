@@ -0,0 +1,381 @@
+#include <cassert>
+#include <algorithm>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "widget.hxx"
+#include "window.hxx"
+#include "scrollable.hxx"
+#include "text_editor.hxx"
+#include "theme.hxx"
+#include "graphics.hxx"
+#include "utils/utf8.hxx"
+
+using namespace eggui;
+
+TextEditor::TextEditor(int w, int h, std::string txt, FontSize font_size_)
+	: Interactive(w, h)
+	, min_height(h)
+	, font_size(font_size_)
+{
+	set_text(std::move(txt));
+}
+
+void TextEditor::set_text(std::string txt)
+{
+	std::vector<int> starts{0};
+	for (auto i = txt.find('\n'); i != txt.npos; i = txt.find('\n', i + 1))
+		starts.push_back(i + 1);
+
+	line_starts.assign(starts, txt.size());
+	text.assign(txt);
+	cursor_at = anchor_at = 0;
+	goal_xpos = -1;
+
+	fit_lines();
+	mark_damaged();
+}
+
+std::string_view TextEditor::get_text() const
+{
+	auto chars = text.data();
+	return std::string_view(chars.data(), chars.size());
+}
+
+std::string TextEditor::get_line(int line) const
+{
+	assert(0 <= line && line < get_line_count());
+
+	int start = line_starts[line];
+	std::string str(get_line_end(line) - start, '\0');
+	text.copy(start, str.size(), str.data());
+	return str;
+}
+
+int TextEditor::find_line(int offset) const
+{
+	// Lines are in the order of their starts, so binary search them.
+	auto lines = std::views::iota(0, get_line_count());
+	auto it = std::ranges::partition_point(lines, [&](int i) {
+		return line_starts[i] <= offset;
+	});
+	return it - lines.begin() - 1;
+}
+
+void TextEditor::set_cursor(int offset, bool keep_selection)
+{
+	cursor_at = std::clamp(offset, 0, static_cast<int>(text.size()));
+	if (!keep_selection)
+		anchor_at = cursor_at;
+	goal_xpos = -1;
+
+	scroll_to_cursor();
+	mark_damaged();
+}
+
+void TextEditor::move_cursor(int delta, bool keep_selection)
+{
+	int pos = cursor_at;
+	int len = text.size();
+
+	// Skip over whole characters.
+	for (; delta > 0 && pos < len; --delta) {
+		do
+			pos++;
+		while (pos < len && is_utf8_continuation(text[pos]));
+	}
+	for (; delta < 0 && pos > 0; ++delta) {
+		do
+			pos--;
+		while (pos > 0 && is_utf8_continuation(text[pos]));
+	}
+
+	set_cursor(pos, keep_selection);
+}
+
+void TextEditor::move_cursor_lines(int delta, bool keep_selection)
+{
+	int line = std::clamp(find_line(cursor_at) + delta, 0, get_line_count() - 1);
+
+	// Keep going straight up or down over shorter lines.
+	float xpos = goal_xpos >= 0 ? goal_xpos : calc_xpos(cursor_at);
+	set_cursor(find_offset(line, xpos), keep_selection);
+	goal_xpos = xpos;
+}
+
+void TextEditor::select(int start, int end)
+{
+	set_cursor(start);
+	set_cursor(end, true);
+}
+
+std::pair<int, int> TextEditor::get_selection() const
+{
+	return std::minmax(anchor_at, cursor_at);
+}
+
+std::string TextEditor::get_selected_text() const
+{
+	auto [start, end] = get_selection();
+	std::string str(end - start, '\0');
+	text.copy(start, str.size(), str.data());
+	return str;
+}
+
+void TextEditor::insert(std::string_view str)
+{
+	erase_selection();
+
+	int line = find_line(cursor_at);
+	text.insert(cursor_at, str);
+
+	// Lines after the cursor move by the length inserted, and there is a new
+	// line after each line break inserted.
+	line_starts.move_gap(line + 1);
+	for (auto i = str.find('\n'); i != str.npos; i = str.find('\n', i + 1))
+		line_starts.insert(++line, cursor_at + i + 1);
+	line_starts.shift(str.size());
+
+	cursor_at = anchor_at = cursor_at + str.size();
+	goal_xpos = -1;
+
+	fit_lines();
+	scroll_to_cursor();
+	mark_damaged();
+}
+
+void TextEditor::delete_before_cursor()
+{
+	if (erase_selection())
+		return;
+
+	int end = cursor_at;
+	move_cursor(-1);
+	erase(cursor_at, end);
+}
+
+void TextEditor::delete_after_cursor()
+{
+	if (erase_selection())
+		return;
+
+	int start = cursor_at;
+	move_cursor(1);
+	erase(start, cursor_at);
+}
+
+void TextEditor::erase(int start, int end)
+{
+	assert(0 <= start && start <= end && end <= int(text.size()));
+
+	// Lines starting inside of the range are merged into the first one.
+	int first = find_line(start);
+	int last = find_line(end);
+	text.erase(start, end - start);
+	line_starts.erase(first + 1, last - first);
+	line_starts.shift(start - end);
+
+	cursor_at = anchor_at = start;
+	goal_xpos = -1;
+
+	fit_lines();
+	scroll_to_cursor();
+	mark_damaged();
+}
+
+bool TextEditor::erase_selection()
+{
+	auto [start, end] = get_selection();
+	if (start == end)
+		return false;
+
+	erase(start, end);
+	return true;
+}
+
+Widget *TextEditor::notify(Event ev)
+{
+	switch (ev.type) {
+	case EventType::FocusGained:
+		is_focused = true;
+		return this;
+
+	case EventType::FocusLost:
+		is_focused = false;
+		return this;
+
+	case EventType::MouseIn:
+		set_cursor_shape(CursorShape::IBeam);
+		return this;
+
+	case EventType::MouseOut:
+		set_cursor_shape(CursorShape::Default);
+		return this;
+
+	// Dragging with the button pressed selects the text.
+	case EventType::MousePressed:
+		ev.window.request_focus(this, true);
+		set_cursor(find_offset(ev.cursor));
+		return this;
+
+	case EventType::MouseDrag:
+		set_cursor(find_offset(ev.cursor), true);
+		return this;
+
+	case EventType::CharEntered:
+		insert(encode_utf8(ev.char_val));
+		return this;
+
+	case EventType::KeyPressed:
+		break;
+
+	default:
+		return Interactive::notify(ev);
+	}
+
+	// Page up and down move by the lines visible in the view.
+	int page = 1;
+	if (auto p = get_parent())
+		page = std::max(1, p->get_size().y / get_line_height());
+
+	int line = find_line(cursor_at);
+
+	switch (static_cast<Key>(ev.keycode)) {
+	case Key::Left:
+		move_cursor(-1);
+		break;
+	case Key::Right:
+		move_cursor(1);
+		break;
+	case Key::Up:
+		move_cursor_lines(-1);
+		break;
+	case Key::Down:
+		move_cursor_lines(1);
+		break;
+	case Key::PageUp:
+		move_cursor_lines(-page);
+		break;
+	case Key::PageDown:
+		move_cursor_lines(page);
+		break;
+	case Key::Home:
+		set_cursor(line_starts[line]);
+		break;
+	case Key::End:
+		set_cursor(get_line_end(line));
+		break;
+	case Key::Enter:
+		insert("\n");
+		break;
+	case Key::Backspace:
+		delete_before_cursor();
+		break;
+	case Key::Delete:
+		delete_after_cursor();
+		break;
+
+	default:
+		break;
+	}
+
+	return this;
+}
+
+void TextEditor::draw()
+{
+	// Only the lines in the visible part of the editor are drawn.
+	int lh = get_line_height();
+	auto [first, last] = calc_visible_rows(lh, get_line_count());
+
+	auto [sel_start, sel_end] = get_selection();
+	float newline_width = tell_glyph_advance(' ', font_size);
+
+	for (int line = first; line < last; ++line) {
+		int start = line_starts[line];
+		int end = get_line_end(line);
+
+		// Highlight the selected part, including the line break.
+		if (sel_start <= end && sel_end > start) {
+			float x0 = sel_start > start ? calc_xpos(sel_start) : 0;
+			float x1 = sel_end <= end ? calc_xpos(sel_end)
+									  : calc_xpos(end) + newline_width;
+			draw_rect(
+				Point(x0, line * lh), Point(x1 - x0, lh), SELECTION_COLOR
+			);
+		}
+
+		auto str = get_line(line);
+		draw_text(Point(0, line * lh), TEXT_COLOR, str.c_str(), font_size);
+	}
+
+	if (is_focused) {
+		Point pos(calc_xpos(cursor_at), find_line(cursor_at) * lh);
+		draw_rect(pos, Point(CURSOR_WIDTH, lh), CURSOR_COLOR);
+	}
+}
+
+int TextEditor::get_line_end(int line) const
+{
+	if (line + 1 < get_line_count())
+		return line_starts[line + 1] - 1;
+	return text.size();
+}
+
+float TextEditor::calc_xpos(int offset) const
+{
+	int start = line_starts[find_line(offset)];
+	std::string str(offset - start, '\0');
+	text.copy(start, str.size(), str.data());
+
+	float xpos = 0;
+	for (std::size_t i = 0; i < str.size();)
+		xpos += tell_glyph_advance(decode_utf8(str, i), font_size);
+
+	return xpos;
+}
+
+int TextEditor::find_offset(int line, float xpos) const
+{
+	int start = line_starts[line];
+	auto str = get_line(line);
+
+	// Stop before the character if the position is in its left half.
+	float x = 0;
+	for (std::size_t i = 0; i < str.size();) {
+		auto at = i;
+		float width = tell_glyph_advance(decode_utf8(str, i), font_size);
+		if (xpos < x + width / 2)
+			return start + at;
+		x += width;
+	}
+
+	return start + str.size();
+}
+
+int TextEditor::find_offset(Point pos) const
+{
+	int line = std::clamp(pos.y / get_line_height(), 0, get_line_count() - 1);
+	return find_offset(line, pos.x);
+}
+
+void TextEditor::fit_lines()
+{
+	// Resized right away, so that scrolling to the cursor sees the new size.
+	set_fixed_height(
+		std::max(min_height, get_line_count() * get_line_height())
+	);
+}
+
+void TextEditor::scroll_to_cursor()
+{
+	auto view = dynamic_cast<VScrollView *>(get_parent());
+	if (!view)
+		return;
+
+	int lh = get_line_height();
+	view->scroll_into_view(find_line(cursor_at) * lh, lh);
+}
@@ -35,6 +35,7 @@ constexpr RGBA TEXT_COLOR(230, 230, 230);
 constexpr RGBA TOAST_COLOR(51, 52, 53);
 
 constexpr RGBA CURSOR_COLOR(216, 0, 101); // (221, 22, 115)
+constexpr RGBA SELECTION_COLOR(216, 0, 101, 80);
 constexpr RGBA TIMER_BAR_COLOR(192, 192, 192);
 
 constexpr RGBA SWITCH_ON_BG(25, 162, 10);
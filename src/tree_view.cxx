@@ -0,0 +1,310 @@
+#include <cassert>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "widget.hxx"
+#include "window.hxx"
+#include "scrollable.hxx"
+#include "tree_view.hxx"
+#include "theme.hxx"
+#include "graphics.hxx"
+
+using namespace eggui;
+
+// TreeView members
+//---------------------------------------------------------
+struct TreeView::Node {
+	TreeItem item;
+	int depth;
+	bool is_expanded = false;
+	bool is_loaded = false;
+	std::vector<std::unique_ptr<Node>> children = {};
+};
+
+TreeView::TreeView(
+	int w, int h, std::vector<TreeItem> roots_, TreeLoader load_children_,
+	FontSize font_size_
+)
+	: Interactive(w, h)
+	, roots(make_nodes(std::move(roots_), 0))
+	, load_children(std::move(load_children_))
+	, min_height(h)
+	, font_size(font_size_)
+{
+	for (auto &node : roots)
+		rows.push_back(node.get());
+	fit_rows();
+}
+
+TreeView::~TreeView() = default;
+
+std::vector<std::unique_ptr<TreeView::Node>> TreeView::make_nodes(
+	std::vector<TreeItem> items, int depth
+)
+{
+	std::vector<std::unique_ptr<Node>> nodes;
+	nodes.reserve(items.size());
+	for (auto &item : items) {
+		nodes.push_back(std::make_unique<Node>(
+			Node{.item = std::move(item), .depth = depth}
+		));
+	}
+
+	return nodes;
+}
+
+const TreeItem &TreeView::get_item(int row) const
+{
+	assert(0 <= row && row < get_row_count());
+	return rows[row]->item;
+}
+
+int TreeView::get_depth(int row) const
+{
+	assert(0 <= row && row < get_row_count());
+	return rows[row]->depth;
+}
+
+bool TreeView::is_expanded(int row) const
+{
+	assert(0 <= row && row < get_row_count());
+	return rows[row]->is_expanded;
+}
+
+void TreeView::expand(int row)
+{
+	assert(0 <= row && row < get_row_count());
+
+	auto &node = *rows[row];
+	if (node.is_expanded || !node.item.has_children)
+		return;
+
+	if (!node.is_loaded) {
+		node.children = make_nodes(load_children(node.item), node.depth + 1);
+		node.is_loaded = true;
+	}
+	node.is_expanded = true;
+
+	// Children expanded earlier are shown expanded again.
+	std::vector<Node *> shown;
+	for (auto &child : node.children)
+		collect_rows(*child, shown);
+	rows.insert(rows.begin() + row + 1, shown.begin(), shown.end());
+
+	if (selected_row > row)
+		selected_row += shown.size();
+
+	fit_rows();
+	mark_damaged();
+}
+
+void TreeView::collapse(int row)
+{
+	assert(0 <= row && row < get_row_count());
+
+	auto &node = *rows[row];
+	if (!node.is_expanded)
+		return;
+
+	int end = find_subtree_end(row);
+	rows.erase(rows.begin() + row + 1, rows.begin() + end);
+	node.is_expanded = false;
+
+	// A hidden selection moves to the collapsed item.
+	if (selected_row > row) {
+		selected_row = selected_row < end ? row
+										  : selected_row - (end - row - 1);
+	}
+
+	fit_rows();
+	mark_damaged();
+}
+
+void TreeView::toggle(int row)
+{
+	if (is_expanded(row))
+		collapse(row);
+	else
+		expand(row);
+}
+
+void TreeView::select_row(int row)
+{
+	assert(-1 <= row && row < get_row_count());
+
+	selected_row = row;
+	if (row >= 0)
+		scroll_to_row(row);
+	mark_damaged();
+}
+
+void TreeView::collect_rows(Node &node, std::vector<Node *> &out)
+{
+	out.push_back(&node);
+	if (!node.is_expanded)
+		return;
+
+	for (auto &child : node.children)
+		collect_rows(*child, out);
+}
+
+int TreeView::find_subtree_end(int row) const
+{
+	int depth = rows[row]->depth;
+	int end = row + 1;
+	while (end < get_row_count() && rows[end]->depth > depth)
+		end++;
+
+	return end;
+}
+
+int TreeView::find_row(Point pos) const
+{
+	if (pos.y < 0)
+		return -1;
+
+	int row = pos.y / get_row_height();
+	return row < get_row_count() ? row : -1;
+}
+
+int TreeView::calc_text_xpos(int row) const
+{
+	// Each level is indented by the width of the marker.
+	return TEXT_PADDING + (rows[row]->depth + 1) * get_row_height();
+}
+
+void TreeView::fit_rows()
+{
+	// Resized right away, so that scrolling to a row sees the new size.
+	set_fixed_height(std::max(min_height, get_row_count() * get_row_height()));
+}
+
+void TreeView::scroll_to_row(int row)
+{
+	auto view = dynamic_cast<VScrollView *>(get_parent());
+	if (!view)
+		return;
+
+	int rh = get_row_height();
+	view->scroll_into_view(row * rh, rh);
+}
+
+Widget *TreeView::notify(Event ev)
+{
+	switch (ev.type) {
+	case EventType::FocusGained:
+		is_focused = true;
+		return this;
+
+	case EventType::FocusLost:
+		is_focused = false;
+		return this;
+
+	// Pressing the marker of an item expands or collapses it.
+	case EventType::MousePressed: {
+		ev.window.request_focus(this, true);
+
+		int row = find_row(ev.cursor);
+		if (row < 0)
+			return this;
+
+		int text_xpos = calc_text_xpos(row);
+		int marker_xpos = text_xpos - get_row_height();
+		if (ev.cursor.x >= marker_xpos && ev.cursor.x < text_xpos)
+			toggle(row);
+		select_row(row);
+		return this;
+	}
+
+	case EventType::KeyPressed:
+		break;
+
+	default:
+		return Interactive::notify(ev);
+	}
+
+	if (rows.empty())
+		return this;
+
+	int row = selected_row;
+	int last = get_row_count() - 1;
+
+	switch (static_cast<Key>(ev.keycode)) {
+	case Key::Up:
+		select_row(std::max(0, row - 1));
+		break;
+	case Key::Down:
+		select_row(std::min(last, row + 1));
+		break;
+	case Key::Home:
+		select_row(0);
+		break;
+	case Key::End:
+		select_row(last);
+		break;
+
+	// Right expands the item, or moves to its first child if expanded.
+	case Key::Right:
+		if (row < 0)
+			break;
+		if (!is_expanded(row))
+			expand(row);
+		else if (row < last && rows[row + 1]->depth > rows[row]->depth)
+			select_row(row + 1);
+		break;
+
+	// Left collapses the item, or moves to its parent if collapsed.
+	case Key::Left:
+		if (row < 0)
+			break;
+		if (is_expanded(row)) {
+			collapse(row);
+		} else {
+			int up = row - 1;
+			while (up >= 0 && rows[up]->depth >= rows[row]->depth)
+				up--;
+			if (up >= 0)
+				select_row(up);
+		}
+		break;
+
+	case Key::Enter:
+		if (row >= 0)
+			toggle(row);
+		break;
+
+	default:
+		break;
+	}
+
+	return this;
+}
+
+void TreeView::draw()
+{
+	// Only the rows in the visible part of the view are drawn.
+	int rh = get_row_height();
+	auto [first, last] = calc_visible_rows(rh, get_row_count());
+
+	for (int row = first; row < last; ++row) {
+		auto &node = *rows[row];
+		int ypos = row * rh;
+
+		if (row == selected_row) {
+			auto color = is_focused ? SELECTION_COLOR : TEXT_BG_COLOR;
+			draw_rect(Point(0, ypos), Point(get_size().x, rh), color);
+		}
+
+		int text_xpos = calc_text_xpos(row);
+		if (node.item.has_children) {
+			auto marker = node.is_expanded ? "-" : "+";
+			Point pos(text_xpos - rh, ypos);
+			draw_text(pos, TEXT_COLOR, marker, font_size);
+		}
+		auto text = node.item.text.c_str();
+		draw_text(Point(text_xpos, ypos), TEXT_COLOR, text, font_size);
+	}
+}
@@ -0,0 +1,124 @@
+#ifndef UTILS_MAPPED_FILE_HXX
+#define UTILS_MAPPED_FILE_HXX
+
+#include <cstddef>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#include <vector>
+#endif
+
+namespace eggui
+{
+/// @brief Read-only view of a whole file, mapped into memory where the
+///        platform allows it, so that pages are only read when touched.
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+	~MappedFile() { close(); }
+
+	/// @brief Map the file, closing the one mapped earlier.
+	/// @return false if the file could not be opened or mapped.
+	bool open(const std::string &path);
+	void close();
+
+	const char *data() const { return bytes; }
+	std::size_t size() const { return length; }
+
+	/// @brief Hint that the file will be read from start to end.
+	void advise_sequential() const;
+
+private:
+	const char *bytes = nullptr;
+	std::size_t length = 0;
+#if !defined(__unix__) && !defined(__APPLE__)
+	std::vector<char> contents;
+#endif
+};
+
+#if defined(__unix__) || defined(__APPLE__)
+inline bool MappedFile::open(const std::string &path)
+{
+	close();
+
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	// Directories and devices open fine, but are not files to be viewed.
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+		::close(fd);
+		return false;
+	}
+
+	// Mapping an empty file fails, but there is nothing to map anyway.
+	if (st.st_size > 0) {
+		void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (addr == MAP_FAILED) {
+			::close(fd);
+			return false;
+		}
+
+		bytes = static_cast<const char *>(addr);
+		length = st.st_size;
+	}
+
+	::close(fd);
+	return true;
+}
+
+inline void MappedFile::close()
+{
+	if (bytes)
+		munmap(const_cast<char *>(bytes), length);
+
+	bytes = nullptr;
+	length = 0;
+}
+
+inline void MappedFile::advise_sequential() const
+{
+	if (bytes)
+		madvise(const_cast<char *>(bytes), length, MADV_SEQUENTIAL);
+}
+#else
+inline bool MappedFile::open(const std::string &path)
+{
+	close();
+
+	// Without mmap the file is read whole.
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+		return false;
+
+	contents.assign(
+		std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()
+	);
+	bytes = contents.data();
+	length = contents.size();
+	return true;
+}
+
+inline void MappedFile::close()
+{
+	contents = {};
+	bytes = nullptr;
+	length = 0;
+}
+
+inline void MappedFile::advise_sequential() const {}
+#endif
+} // namespace eggui
+
+#endif
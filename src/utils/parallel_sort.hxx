@@ -0,0 +1,93 @@
+#ifndef UTILS_PARALLEL_SORT_HXX
+#define UTILS_PARALLEL_SORT_HXX
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace eggui
+{
+/// @brief Sort the range on several threads. Parts of the range are sorted,
+///        and then neighbouring runs of parts are merged a pair at a time,
+///        until the whole range is merged. The threads take the next part
+///        to sort or pair to merge as they get free.
+///
+/// @details
+/// The range is split into more parts than threads, so that each part sort
+/// or merge is short, and the stop flag is checked before each of them.
+/// Once stopped, the range is left partly sorted.
+///
+/// @param less Comparison, called from all the threads at once.
+/// @param thread_count Number of threads to use, at least one. The calling
+///        thread is one of them.
+/// @param stop Flag to give up sorting, set from any thread.
+/// @return false if stopped before the range was sorted.
+template <typename It, typename Less>
+bool parallel_sort(
+	It first, It last, const Less &less, unsigned thread_count,
+	const std::atomic<bool> &stop
+)
+{
+	constexpr std::size_t PARTS_PER_THREAD = 8;
+
+	thread_count = std::max(1u, thread_count);
+	std::size_t len = last - first;
+	std::size_t parts = std::min(
+		thread_count * PARTS_PER_THREAD, std::max<std::size_t>(len, 1)
+	);
+
+	// Part i is [bounds[i], bounds[i + 1]).
+	std::vector<std::size_t> bounds(parts + 1);
+	for (std::size_t i = 0; i <= parts; ++i)
+		bounds[i] = len * i / parts;
+
+	auto is_stopped = [&stop]() {
+		return stop.load(std::memory_order_relaxed);
+	};
+
+	// Run `task(i)` for each i in [0, count) on the threads.
+	auto run_tasks = [&](std::size_t count, const auto &task) {
+		std::atomic<std::size_t> next = 0;
+		auto work = [&]() {
+			for (;;) {
+				auto i = next.fetch_add(1, std::memory_order_relaxed);
+				if (i >= count || is_stopped())
+					return;
+				task(i);
+			}
+		};
+
+		std::vector<std::thread> threads;
+		auto helpers = std::min<std::size_t>(thread_count, count);
+		for (std::size_t t = 1; t < helpers; ++t)
+			threads.emplace_back(work);
+		work();
+		for (auto &t : threads)
+			t.join();
+	};
+
+	run_tasks(parts, [&](std::size_t i) {
+		std::sort(first + bounds[i], first + bounds[i + 1], less);
+	});
+
+	// Each round merges pairs of runs, doubling the parts in a run.
+	for (std::size_t width = 1; width < parts; width *= 2) {
+		run_tasks((parts + 2 * width - 1) / (2 * width), [&](std::size_t p) {
+			std::size_t i = p * 2 * width;
+			if (i + width >= parts)
+				return;
+
+			auto start = first + bounds[i];
+			auto mid = first + bounds[i + width];
+			auto end = first + bounds[std::min(i + 2 * width, parts)];
+			std::inplace_merge(start, mid, end, less);
+		});
+	}
+
+	return !is_stopped();
+}
+} // namespace eggui
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef UTILS_RANGE_MAX_HXX
+#define UTILS_RANGE_MAX_HXX
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <limits>
+#include <vector>
+
+namespace eggui
+{
+/// @brief Raises ranges of values to at least a given value, for many ranges
+///        at once.
+///
+/// @details
+/// Works like a sparse table in reverse. A range is covered by two ranges,
+/// possibly overlapping, of the largest power of two length which fits in
+/// it, and the value is recorded at the start of both for that length. Once
+/// all the ranges are raised, values recorded for each length are pushed
+/// down to both halves of the length below. So raising a range takes O(1)
+/// time, however long it is, and applying takes O(n log(longest range)).
+class RangeMax
+{
+public:
+	/// @brief Start afresh, for raising ranges of `n` values.
+	void reset(int n)
+	{
+		count = n;
+		levels.resize(1);
+		levels[0].assign(count, NONE);
+	}
+
+	/// @brief Raise values in [first, last) to at least `value`.
+	void raise(int first, int last, int value)
+	{
+		assert(0 <= first && first < last && last <= count);
+
+		int level = std::bit_width(unsigned(last - first)) - 1;
+		while (int(levels.size()) <= level)
+			levels.emplace_back(count, NONE);
+
+		auto &starts = levels[level];
+		int len = 1 << level;
+		starts[first] = std::max(starts[first], value);
+		starts[last - len] = std::max(starts[last - len], value);
+	}
+
+	/// @brief Raise each of `values` to the largest value raised over it.
+	void apply(std::vector<int> &values)
+	{
+		assert(int(values.size()) == count);
+
+		for (int level = levels.size() - 1; level > 0; --level) {
+			auto &starts = levels[level];
+			auto &halves = levels[level - 1];
+			int half = 1 << (level - 1);
+			for (int i = 0; i + 2 * half <= count; ++i) {
+				if (starts[i] == NONE)
+					continue;
+				halves[i] = std::max(halves[i], starts[i]);
+				halves[i + half] = std::max(halves[i + half], starts[i]);
+			}
+		}
+
+		for (int i = 0; i < count; ++i)
+			values[i] = std::max(values[i], levels[0][i]);
+	}
+
+private:
+	static constexpr int NONE = std::numeric_limits<int>::min();
+
+	// Values raised over [i, i + 2^level) for each level, NONE if none.
+	std::vector<std::vector<int>> levels;
+	int count = 0;
+};
+} // namespace eggui
+
+#endif
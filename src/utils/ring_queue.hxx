@@ -0,0 +1,94 @@
+#ifndef UTILS_RING_QUEUE_HXX
+#define UTILS_RING_QUEUE_HXX
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace eggui
+{
+/// @brief Bounded lock-free queue, any number of threads may push into it
+///        and a single thread pops from it.
+///
+/// @details
+/// Items are kept in a ring of slots, each with a sequence number telling
+/// whether it is free to be pushed into or ready to be popped from for the
+/// current lap around the ring. Producers claim slots by advancing the tail.
+template <typename T>
+class RingQueue
+{
+public:
+	/// @param capacity Rounded up to a power of two.
+	explicit RingQueue(std::size_t capacity)
+		: mask(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1)
+		, slots(std::make_unique<Slot[]>(mask + 1))
+	{
+		for (std::size_t i = 0; i <= mask; ++i)
+			slots[i].seq.store(i, std::memory_order_relaxed);
+	}
+
+	std::size_t capacity() const { return mask + 1; }
+
+	/// @brief Push the item, from any thread.
+	/// @return false if the queue is full, the item is not pushed then.
+	bool push(T item)
+	{
+		auto pos = tail.load(std::memory_order_relaxed);
+		for (;;) {
+			auto &slot = slots[pos & mask];
+			auto seq = slot.seq.load(std::memory_order_acquire);
+			auto lag = static_cast<std::intptr_t>(seq - pos);
+
+			if (lag == 0) {
+				// The slot is free, claim it unless another producer did.
+				if (tail.compare_exchange_weak(
+						pos, pos + 1, std::memory_order_relaxed
+					)) {
+					slot.item = std::move(item);
+					slot.seq.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			} else if (lag < 0) {
+				// The slot still holds an item from the previous lap.
+				return false;
+			} else {
+				pos = tail.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/// @brief Pop the oldest item, only from the consumer thread.
+	/// @return false if the queue is empty.
+	bool pop(T &out)
+	{
+		auto &slot = slots[head & mask];
+		if (slot.seq.load(std::memory_order_acquire) != head + 1)
+			return false;
+
+		out = std::move(slot.item);
+		// Free the slot for the next lap.
+		slot.seq.store(head + mask + 1, std::memory_order_release);
+		head++;
+		return true;
+	}
+
+private:
+	struct Slot {
+		std::atomic<std::size_t> seq;
+		T item;
+	};
+
+	const std::size_t mask;
+	std::unique_ptr<Slot[]> slots;
+	// Producers and the consumer work on different ends, keep them apart so
+	// that they do not share a cache line.
+	alignas(64) std::atomic<std::size_t> tail = 0;
+	alignas(64) std::size_t head = 0;
+};
+} // namespace eggui
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef UTILS_UTF8_HXX
+#define UTILS_UTF8_HXX
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace eggui
+{
+/// @brief Decode the UTF-8 encoded character starting at the index.
+/// @param text The text.
+/// @param i Index of its first byte, moved past the character.
+/// @return Unicode codepoint, '?' for an invalid byte like raylib does.
+inline int decode_utf8(std::string_view text, std::size_t &i)
+{
+	auto byte = [&text](std::size_t at) {
+		return static_cast<unsigned char>(text[at]);
+	};
+
+	unsigned lead = byte(i);
+	int len = lead < 0x80 ? 1
+			  : (lead & 0xE0) == 0xC0 ? 2
+			  : (lead & 0xF0) == 0xE0 ? 3
+			  : (lead & 0xF8) == 0xF0 ? 4
+									  : 0;
+
+	if (len == 0 || i + len > text.size()) {
+		i++;
+		return '?';
+	}
+
+	int codepoint = len == 1 ? lead : lead & (0x7F >> len);
+	for (int k = 1; k < len; ++k) {
+		unsigned next = byte(i + k);
+		if ((next & 0xC0) != 0x80) {
+			i++;
+			return '?';
+		}
+		codepoint = codepoint << 6 | (next & 0x3F);
+	}
+
+	i += len;
+	return codepoint;
+}
+
+/// @brief Encode the codepoint as UTF-8.
+/// @param codepoint Unicode codepoint, '?' is encoded if it is invalid.
+inline std::string encode_utf8(int codepoint)
+{
+	auto cont = [codepoint](int shift) {
+		return static_cast<char>(0x80 | (codepoint >> shift & 0x3F));
+	};
+
+	if (codepoint < 0 || codepoint > 0x10FFFF)
+		return "?";
+	if (codepoint < 0x80)
+		return std::string(1, static_cast<char>(codepoint));
+	if (codepoint < 0x800)
+		return {static_cast<char>(0xC0 | codepoint >> 6), cont(0)};
+	if (codepoint < 0x10000)
+		return {static_cast<char>(0xE0 | codepoint >> 12), cont(6), cont(0)};
+	return {
+		static_cast<char>(0xF0 | codepoint >> 18), cont(12), cont(6), cont(0)
+	};
+}
+
+/// @brief Check if the byte continues a UTF-8 character, instead of
+///        starting one.
+inline bool is_utf8_continuation(char byte)
+{
+	return (static_cast<unsigned char>(byte) & 0xC0) == 0x80;
+}
+} // namespace eggui
+
+#endif
@@ -6,15 +6,47 @@
 #include "container.hxx"
 #include "graphics.hxx"
 #include "canvas.hxx"
+#include "managers.hxx"
 
 namespace eggui
 {
 void draw_widget(Widget &w)
 {
+	// Inside of a recording a widget is recorded as a sub-draw, so that it
+	// draws(or replays) itself as per its own state when replayed.
+	if (is_recording()) {
+		auto draw_fn = [](void *arg) {
+			draw_widget(*static_cast<Widget *>(arg));
+		};
+		draw_subdraw(draw_fn, &w);
+		return;
+	}
+
+	// Skip the widget without even acquiring a pen if it would be clipped.
+	auto [clip_pos, clip_size] = get_unclipped_region();
+	auto [region_pos, region_size] = w.canvas.get_draw_region();
+	region_pos += w.get_position();
+	if (!check_box_collision(region_pos, region_size, clip_pos, clip_size)) {
+		w.is_drawing_visible = false;
+		return;
+	}
+
 	const auto pen = w.canvas.acquire_pen();
 	w.is_drawing_visible = w.is_visible(pen);
-	if (w.is_drawing_visible)
+	if (!w.is_drawing_visible)
+		return;
+
+	if (!w.retained) {
+		w.draw();
+	} else if (w.is_draw_list_valid) {
+		w.draw_list.replay();
+	} else {
+		w.draw_list.clear();
+		begin_recording(w.draw_list);
 		w.draw();
+		end_recording();
+		w.is_draw_list_valid = true;
+	}
 }
 
 void draw_widget_debug(Widget &w)
@@ -39,6 +71,21 @@ void Widget::set_size(Point new_size)
 	assert(get_max_size().x >= new_size.x && get_max_size().y >= new_size.y);
 
 	canvas.set_size(new_size);
+	note_tree_changed();
+	is_draw_list_valid = false;
+	needs_layout_calc = false;
+	needs_relayout = false;
+}
+
+void Widget::set_fixed_height(int height)
+{
+	if (height == get_size().y)
+		return;
+
+	set_min_size(Point(get_min_size().x, height));
+	set_max_size(Point(get_max_size().x, height));
+	set_size(Point(get_size().x, height));
+	invalidate_layout();
 }
 
 void Widget::set_all_sizes(Point size)
@@ -48,16 +95,53 @@ void Widget::set_all_sizes(Point size)
 	set_size(size);
 }
 
-void Widget::set_position(Point new_pos) { canvas.set_position(new_pos); }
+void Widget::set_position(Point new_pos)
+{
+	canvas.set_position(new_pos);
+	position_generation++;
+	note_tree_changed();
+}
+
+void Widget::invalidate_layout()
+{
+	note_tree_changed();
+
+	// Ancestors of a widget with stale layout are already marked stale.
+	for (auto w = this; w && !w->needs_layout_calc; w = w->parent) {
+		w->needs_layout_calc = true;
+		w->needs_relayout = true;
+	}
+}
 
 Point Widget::calc_abs_position() const
 {
-	Point ret = get_position();
+	if (abs_position_generation == position_generation)
+		return abs_position;
+
+	// Ancestors cache their positions too, so after a move each widget is
+	// calculated again only once, however many of its descendants ask.
+	abs_position = get_position();
+	if (parent)
+		abs_position += parent->calc_abs_position();
+	abs_position_generation = position_generation;
+
+	return abs_position;
+}
+
+void Widget::mark_damaged(Point start, Point size)
+{
+	is_draw_list_valid = false;
+	DamageManager::instance().add_area(calc_abs_position() + start, size);
 
 	for (auto p = get_parent(); p; p = p->get_parent())
-		ret += p->get_position();
+		p->on_descendant_damaged();
+}
 
-	return ret;
+void Widget::set_retained(bool enable)
+{
+	retained = enable;
+	is_draw_list_valid = false;
+	draw_list.clear();
 }
 
 void Widget::draw_debug()
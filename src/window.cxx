@@ -2,19 +2,17 @@
 #include <algorithm>
 #include <ranges>
 
-#include "raylib/raylib.h"
-
 #include "graphics.hxx"
+#include "backend.hxx"
 #include "window.hxx"
 #include "widget.hxx"
 #include "theme.hxx"
+#include "managers.hxx"
 #include "utils/swap_remove.hxx"
 
 using namespace eggui;
 
-inline Point vec2_to_point(Vector2 v) { return Point(v.x, v.y); };
-
-inline Point get_mouse_pos() { return vec2_to_point(GetMousePosition()); }
+inline Point get_mouse_pos() { return get_backend().get_mouse_position(); }
 
 inline Point widget_parent_pos(Widget &w)
 {
@@ -28,7 +26,7 @@ void Window::set_title(std::string title_str)
 {
 	title = std::move(title_str);
 	if (is_running)
-		SetWindowTitle(title.c_str());
+		get_backend().set_title(title.c_str());
 }
 
 void Window::main_loop(int width_hint, int height_hint)
@@ -38,51 +36,45 @@ void Window::main_loop(int width_hint, int height_hint)
 	layout(Point(width_hint, height_hint));
 	auto size = root_widget->get_size();
 
-	SetTraceLogLevel(LOG_WARNING);
-	SetConfigFlags(FLAG_WINDOW_RESIZABLE | FLAG_VSYNC_HINT | FLAG_MSAA_4X_HINT);
-	InitWindow(size.x, size.y, title.c_str());
+	auto &backend = get_backend();
+	backend.open_window(size, title.c_str());
 	init_graphics();
 
-	// This is not really needed since we also check for frame timing manually,
-	// but just in case the default FPS is too low and it sleeps for too long.
-	if (!IsWindowState(FLAG_VSYNC_HINT))
-		SetTargetFPS(TICKS_PER_SECOND);
-
 	set_resize_limits();
 
-	SetExitKey(KEY_NULL); // Do not exit on ESC.
-	EnableEventWaiting(); // Sleep untill a new input event arrives.
+	backend.set_event_waiting(true); // Sleep untill a new input event arrives.
 	event_waiting_enabled = true;
-	last_update_time = GetTime();
+	last_update_time = backend.get_time();
 	is_running = true;
 
-	// We draw frames only when something changes.
-	// A change is defined as:
+	// We draw frames only when something changes, and then only the areas
+	// which changed. A change is defined as:
 	//     A widget acknowledges responding to an event we sent to it.
+	//     A widget reports that it has been damaged.
 	//     State of the window changes.
 	//     A new animation frame is required.
-	while (!((WindowShouldClose() || close_requested) && close_action(*this))) {
+	while (!((backend.should_close() || close_requested) && close_action(*this))
+	) {
 		update();
-		last_update_time = GetTime();
+		last_update_time = backend.get_time();
 
 		// Poll for events manually when nothing is drawn, since when we draw
 		// events are polled by the draw method.
-		if (draw_cnt > 0) {
-			draw_cnt--;
+		if (draw_cnt > 0 || DamageManager::instance().has_damage()) {
 			draw();
 		} else {
-			PollInputEvents();
+			backend.poll_events();
 		}
 
 		// Manage frame timing as per the update interval, sleep if time left.
 		if (auto extra = UPDATE_DELTA_TIME - get_update_dt(); extra > 0) {
-			WaitTime(extra);
+			backend.wait_time(extra);
 		}
 	}
 
 	is_running = false;
 	deinit_graphics();
-	CloseWindow();
+	backend.close_window();
 }
 
 void Window::add_animation(Widget *w, Animation animation)
@@ -112,6 +104,8 @@ void Window::add_overlay(std::shared_ptr<Widget> w, int z_index)
 		.removed = false,
 	};
 	overlays.insert(at, item);
+	item.widget->mark_damaged();
+	is_probe_valid = false;
 }
 
 void Window::remove_overlay(Widget *w)
@@ -119,6 +113,8 @@ void Window::remove_overlay(Widget *w)
 	for (auto &ov : overlays) {
 		if (ov.widget.get() == w) {
 			ov.removed = true;
+			w->mark_damaged();
+			is_probe_valid = false;
 			return;
 		}
 	}
@@ -150,20 +146,21 @@ void Window::request_close_window(Widget *w)
 void Window::update()
 {
 	// If window is resized then just re-layout and ignore any other events.
-	if (IsWindowResized()) {
+	auto &backend = get_backend();
+	if (backend.is_resized()) {
 		// HACK - We draw twice when resized.
 		// Drawing only once causes small black square shaped boxes to appear
 		// at top-right and bottom-left corners and the drawing of that part to
 		// be shifted. This only happend when the window is maximized.
 		draw_cnt = 2;
 
-		layout(Point(GetScreenWidth(), GetScreenHeight()));
+		layout(get_window_size());
 		set_resize_limits();
 		return;
 	}
 
 #ifndef NDEBUG
-	if (IsKeyPressed(KEY_ESCAPE)) {
+	if (backend.is_key_pressed(Key::Escape)) {
 		debug_borders_enabled = !debug_borders_enabled;
 		draw_cnt = 1;
 	}
@@ -172,20 +169,29 @@ void Window::update()
 	// Any new animations added by event handlers will be started in the
 	// next update call.
 	play_animations();
+	TickManager::instance().tick();
 	handle_mouse_events();
 	handle_keyboard_events();
 
+	// Only the subtrees whose layout was invalidated are laid out again.
+	if (root_widget->needs_layout()) {
+		draw_cnt = std::max(draw_cnt, 1);
+		layout(get_window_size());
+		set_resize_limits();
+	}
+
 	// If there are any animations pending then keep event waiting disabled.
 	// Also start the animation timer to ensure accurate animation step
-	// timings regardless of the update interval.
-	if (!animations.empty()) {
+	// timings regardless of the update interval. Widgets waiting on other
+	// threads need the updates to keep coming too.
+	if (!animations.empty() || TickManager::instance().has_tickers()) {
 		if (event_waiting_enabled) {
-			DisableEventWaiting();
+			backend.set_event_waiting(false);
 			animation_lag = 0;
 			event_waiting_enabled = false;
 		}
 	} else if (!event_waiting_enabled) {
-		EnableEventWaiting();
+		backend.set_event_waiting(true);
 		event_waiting_enabled = true;
 	}
 
@@ -194,15 +200,48 @@ void Window::update()
 	auto [lo, hi] = std::ranges::remove_if(overlays, [](const auto &overlay) {
 		return overlay.removed;
 	});
-	overlays.erase(lo, hi);
+	if (lo != hi) {
+		overlays.erase(lo, hi);
+		is_probe_valid = false;
+	}
 }
 
 void Window::draw()
 {
-	BeginDrawing();
+	auto &damage = DamageManager::instance();
+	if (draw_cnt > 0) {
+		draw_cnt--;
+		damage.add_area(Point(0, 0), get_window_size());
+	}
+
+	// Drawing happens on the back buffer which holds the frame drawn before
+	// the last one, so areas drawn in the last frame are drawn again too.
+	auto fresh_areas = damage.take_areas();
+	for (auto [pos, size] : fresh_areas)
+		damage.add_area(pos, size);
+	for (auto [pos, size] : last_drawn_areas)
+		damage.add_area(pos, size);
+
+	auto areas = damage.take_areas();
+	last_drawn_areas = std::move(fresh_areas);
+
+	get_backend().begin_frame();
+	begin_batching();
+
+	// Widgets lying outside of the clipped area are not drawn.
+	for (auto [pos, size] : areas) {
+		ClippingManager::instance().push_clip_area(pos, size);
+		draw_rect(pos, size, BACKGROUND_COLOR);
+		draw_widgets();
+		ClippingManager::instance().pop_clip_area();
+	}
 
-	clear_background();
+	end_batching();
+	get_backend().end_frame();
+}
 
+void Window::draw_widgets()
+{
 	draw_widget(*root_widget);
 	if (debug_borders_enabled)
 		draw_widget_debug(*root_widget);
@@ -220,70 +259,77 @@ void Window::draw()
 
 		pop_translation();
 	}
-
-	EndDrawing();
 }
 
 void Window::layout(Point size)
 {
+	// Containers re-measure and re-place only the stale subtrees.
 	root_widget->set_size(size);
 	root_widget->set_position(Point(0, 0));
+	is_probe_valid = false;
 }
 
 void Window::set_resize_limits()
 {
-	if (!IsWindowReady())
+	auto &backend = get_backend();
+	if (!backend.is_window_open())
 		return;
 
 	const Point win_min(1, 1);
-	const Point win_max(
-		GetMonitorWidth(GetCurrentMonitor()),
-		GetMonitorHeight(GetCurrentMonitor())
-	);
+	const Point win_max = backend.get_monitor_size();
 
 	auto minsz = root_widget->get_min_size();
 	auto maxsz = root_widget->get_max_size();
 	minsz = clamp_components(minsz, win_min, win_max);
 	maxsz = clamp_components(maxsz, win_min, win_max);
 
-	SetWindowMinSize(minsz.x, minsz.y);
-	SetWindowMaxSize(maxsz.x, maxsz.y);
+	backend.set_size_limits(minsz, maxsz);
 }
 
-void Window::handle_mouse_events()
+std::pair<Widget *, Widget *> Window::probe_hovered()
 {
-
-	Widget *hovered = nullptr;
-	bool handeled = false;
+	auto cursor = get_mouse_pos();
+	if (is_probe_valid && cursor == probed_cursor
+		&& Widget::get_tree_generation() == probed_generation)
+		return std::pair(probed_target, probed_hovered);
 
 	// First check if the cursor is hovering over any of the overlays
 	// and then check it for the root_widget if not.
-	// We always send the scroll event over the widget we are hovering,
+	Widget *target = root_widget.get();
 	for (auto &ov : overlays) {
 		auto pos = ov.widget->calc_abs_position();
 		auto size = ov.widget->get_size();
-		if (!get_mouse_pos().is_in_box(pos, size))
-			continue;
-
-		send_scroll_to(ov.widget.get());
-		hovered = notify_n_ack(ov.widget.get(), EventType::IsInteractive);
-		handeled = true;
-		break;
+		if (cursor.is_in_box(pos, size)) {
+			target = ov.widget.get();
+			break;
+		}
 	}
 
-	if (!handeled) {
-		hovered = notify_n_ack(root_widget.get(), EventType::IsInteractive);
-		send_scroll_to(root_widget.get());
-	}
+	is_probe_valid = true;
+	probed_cursor = cursor;
+	probed_generation = Widget::get_tree_generation();
+	probed_target = target;
+	probed_hovered = notify_n_ack(target, EventType::IsInteractive);
+	return std::pair(probed_target, probed_hovered);
+}
+
+void Window::handle_mouse_events()
+{
+	auto &backend = get_backend();
+
+	// We always send the scroll event over the widget we are hovering, the
+	// widgets it moves are probed again on the next update.
+	auto [target, hovered] = probe_hovered();
+	send_scroll_to(target);
 
 	// *** Handle mouse button press/release and drag ***
 	if (!mouse_down_over) {
 		// Some widget responds to the mouse press.
-		if (hovered && IsMouseButtonPressed(MOUSE_BUTTON_LEFT))
+		if (hovered && backend.is_mouse_pressed())
 			mouse_down_over = notify_n_ack(hovered, EventType::MousePressed);
 	}
 	// If mouse released while it was down over some widget.
-	else if (IsMouseButtonReleased(MOUSE_BUTTON_LEFT)) {
+	else if (backend.is_mouse_released()) {
 		// Register a click only if the mouse button is released while
 		// hovering over the same widget it was pressed upon.
 		if (mouse_down_over == hovered)
@@ -298,7 +344,7 @@ void Window::handle_mouse_events()
 	else {
 		hovered = mouse_down_over;
 		// Mouse moved while a mouse button is pressed over the widget.
-		auto delta = vec2_to_point(GetMouseDelta());
+		auto delta = backend.get_mouse_delta();
 		if (delta.x != 0 || delta.y != 0)
 			notify_n_ack(mouse_down_over, EventType::MouseDrag, delta);
 	}
@@ -308,7 +354,7 @@ void Window::handle_mouse_events()
 	// the focus pinned, then it loses its focus.
 	// Since hovered can be a nullptr, we check for button press explicitly.
 	if (!keep_focus_pinned && focused_on && hovered != focused_on
-		&& IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
+		&& backend.is_mouse_pressed()) {
 		notify_n_ack(focused_on, EventType::FocusLost);
 		focused_on = nullptr;
 	}
@@ -327,7 +373,7 @@ void Window::handle_mouse_events()
 	// where the mouse is hovering over it along with its delta. Otherwise,
 	// notify the new widget that it is being hovered over.
 	if (hovering_over == hovered) {
-		auto delta = vec2_to_point(GetMouseDelta());
+		auto delta = backend.get_mouse_delta();
 		notify_n_ack(hovered, EventType::MouseMotion, delta);
 	} else {
 		notify_n_ack(hovered, EventType::MouseIn);
@@ -337,7 +383,7 @@ void Window::handle_mouse_events()
 
 void Window::send_scroll_to(Widget *w)
 {
-	auto scroll = vec2_to_point(GetMouseWheelMoveV());
+	auto scroll = get_backend().get_mouse_wheel();
 	if (scroll.x != 0 || scroll.y != 0)
 		notify_n_ack(w, EventType::Scroll, scroll);
 }
@@ -348,16 +394,19 @@ void Window::handle_keyboard_events()
 		return;
 
 	// TODO Cleanup this keyboard testing stuff
-	int charc = GetCharPressed();
+	auto &backend = get_backend();
+	int charc = backend.get_char_pressed();
 	if (charc != 0) {
 		Event ev(*this, EventType::CharEntered, charc);
-		notify_widget(*focused_on, ev);
+		if (auto w = notify_widget(*focused_on, ev))
+			w->mark_damaged();
 	}
 
-	int keyc = GetKeyPressed();
-	if (charc == 0 && keyc != KEY_NULL) {
-		Event ev(*this, EventType::KeyPressed, keyc);
-		notify_widget(*focused_on, ev);
+	auto keyc = backend.get_key_pressed();
+	if (charc == 0 && keyc != Key::Null) {
+		Event ev(*this, EventType::KeyPressed, static_cast<int>(keyc));
+		if (auto w = notify_widget(*focused_on, ev))
+			w->mark_damaged();
 	};
 }
 
@@ -369,8 +418,8 @@ void Window::play_animations()
 
 	while (animation_lag >= UPDATE_DELTA_TIME) {
 		for (auto &a : animations) {
-			if (!a.second.has_ended())
-				draw_cnt = a.second.update() ? 1 : draw_cnt;
+			if (!a.second.has_ended() && a.second.update())
+				a.first->mark_damaged();
 		}
 
 		animation_lag -= UPDATE_DELTA_TIME;
@@ -385,13 +434,20 @@ Widget *Window::notify_n_ack(Widget *w, EventType type, Point extra)
 {
 	assert(w);
 
-	auto ev = Event(*this, type, get_mouse_pos());
+	// The widget may be nested deep, so make the cursor relative to its
+	// parent, like it is when the event is passed down by the parent.
+	auto ev = Event(*this, type, get_mouse_pos() - widget_parent_pos(*w));
 	ev.delta = extra;
 
+	// Responding to a query does not change anything.
 	auto ret = notify_widget(*w, ev);
-	draw_cnt = ret && draw_cnt == 0 ? 1 : draw_cnt;
+	if (ret && type != EventType::IsInteractive)
+		ret->mark_damaged();
 
 	return ret;
 }
 
-double Window::get_update_dt() const { return GetTime() - last_update_time; }
+double Window::get_update_dt() const
+{
+	return get_backend().get_time() - last_update_time;
+}